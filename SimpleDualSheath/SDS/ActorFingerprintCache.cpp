@@ -0,0 +1,59 @@
+#include "pch.h"
+
+#include "ActorFingerprintCache.h"
+
+namespace SDS
+{
+	bool ActorFingerprintCache::Changed(
+		Game::FormID       a_actor,
+		const Fingerprint& a_fingerprint) const
+	{
+		IScopedLock lock(m_lock);
+
+		auto it = m_data.find(a_actor);
+		if (it == m_data.end() || !(it->second == a_fingerprint))
+		{
+			m_changed++;
+			return true;
+		}
+
+		m_unchanged++;
+
+		return false;
+	}
+
+	void ActorFingerprintCache::Set(
+		Game::FormID       a_actor,
+		const Fingerprint& a_fingerprint)
+	{
+		IScopedLock lock(m_lock);
+
+		m_data.insert_or_assign(a_actor, a_fingerprint);
+	}
+
+	void ActorFingerprintCache::Invalidate(Game::FormID a_actor)
+	{
+		IScopedLock lock(m_lock);
+
+		m_data.erase(a_actor);
+	}
+
+	void ActorFingerprintCache::Clear()
+	{
+		IScopedLock lock(m_lock);
+
+		m_data.clear();
+	}
+
+	auto ActorFingerprintCache::GetStats() const
+		-> Stats
+	{
+		IScopedLock lock(m_lock);
+
+		return {
+			m_unchanged,
+			m_changed,
+			m_data.size()
+		};
+	}
+}
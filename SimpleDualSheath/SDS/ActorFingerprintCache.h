@@ -0,0 +1,60 @@
+#pragma once
+
+namespace SDS
+{
+	// what the last reparenting pass was based on, per actor. if none of it changed
+	// since, running it again can't move anything.
+	class ActorFingerprintCache
+	{
+	public:
+		struct Fingerprint
+		{
+			Game::FormID left;
+			Game::FormID right;
+			const void*  root3p{ nullptr };  // identity only, never dereferenced
+			const void*  root1p{ nullptr };
+			bool         drawn{ false };
+			bool         toggle{ false };
+
+			[[nodiscard]] inline bool operator==(const Fingerprint& a_rhs) const noexcept
+			{
+				return left == a_rhs.left &&
+				       right == a_rhs.right &&
+				       root3p == a_rhs.root3p &&
+				       root1p == a_rhs.root1p &&
+				       drawn == a_rhs.drawn &&
+				       toggle == a_rhs.toggle;
+			}
+		};
+
+		struct Stats
+		{
+			std::uint64_t unchanged;
+			std::uint64_t changed;
+			std::size_t   actors;
+		};
+
+		ActorFingerprintCache() = default;
+
+		ActorFingerprintCache(const ActorFingerprintCache&)            = delete;
+		ActorFingerprintCache& operator=(const ActorFingerprintCache&) = delete;
+
+		// true if it differs from what's stored (or nothing is)
+		[[nodiscard]] bool Changed(Game::FormID a_actor, const Fingerprint& a_fingerprint) const;
+
+		// only after a run that found everything it was looking for
+		void Set(Game::FormID a_actor, const Fingerprint& a_fingerprint);
+
+		void Invalidate(Game::FormID a_actor);
+		void Clear();
+
+		[[nodiscard]] Stats GetStats() const;
+
+	private:
+		mutable WCriticalSection                      m_lock;
+		std::unordered_map<Game::FormID, Fingerprint> m_data;
+
+		mutable std::uint64_t m_unchanged{ 0 };
+		mutable std::uint64_t m_changed{ 0 };
+	};
+}
@@ -91,6 +91,9 @@ namespace SDS
 
 		m_disableScabbards       = reader.GetBoolValue(SECT_GENERAL, "DisableAllScabbards", false);
 		m_disableWeapNodeSharing = reader.GetBoolValue(SECT_GENERAL, "DisableWeaponNodeSharing", false);
+		m_watchConfigFile        = reader.GetBoolValue(SECT_GENERAL, "WatchConfigFile", false);
+		m_animEventReattach      = reader.GetBoolValue(SECT_GENERAL, "AnimationEventReattach", false);
+		m_updateBudget           = static_cast<std::uint32_t>(std::max(reader.GetLongValue(SECT_GENERAL, "UpdateBudget", 1000), 0l));
 
 		m_sword = {
 			FlagParser::Parse(reader.GetValue(SECT_SWORD, KW_FLAGS, "Player|NPC")),
@@ -132,14 +135,73 @@ namespace SDS
 			reader.GetValue(SECT_SHIELD, KW_SHEATHNODE, StringHolder::NINODE_SHIELD_BACK)
 		};
 
+		m_overrides.clear();
+
+		std::vector<std::string> sections;
+		stl::split_string(reader.GetValue(SECT_OVERRIDES, "Sections", ""), '|', sections, true);
+
+		for (auto& e : sections)
+		{
+			auto& entry = m_overrides.emplace_back();
+
+			entry.m_name   = e;
+			entry.m_config = {
+				FlagParser::Parse(reader.GetValue(e.c_str(), KW_FLAGS, "Player|NPC")),
+				reader.GetValue(e.c_str(), KW_SHEATHNODE, "")
+			};
+
+			stl::split_string(reader.GetValue(e.c_str(), "Forms", ""), '|', entry.m_forms, true);
+			stl::split_string(reader.GetValue(e.c_str(), "Keywords", ""), '|', entry.m_keywords, true);
+			stl::split_string(reader.GetValue(e.c_str(), "Races", ""), '|', entry.m_races, true);
+			stl::split_string(reader.GetValue(e.c_str(), "Types", ""), '|', entry.m_types, true);
+		}
+
 		m_shieldHandWorkaround = reader.GetBoolValue(SECT_SHIELD, "ClenchedHandWorkaround", false);
 		m_shwForceIfDrawn      = reader.GetBoolValue(SECT_SHIELD, "ClenchedHandWorkaroundForceIfDrawn", false);
 		m_shieldHideFlags      = FlagParser::Parse(reader.GetValue(SECT_SHIELD, "DisableHideOnSit", ""));
 		m_shieldToggleKeys.Parse(reader.GetValue(SECT_SHIELD, "ToggleKeys", ""));
 
-		m_npcEquipLeft = reader.GetBoolValue(SECT_NPC, "EquipLeft", false);
+		m_npcEquipLeft  = reader.GetBoolValue(SECT_NPC, "EquipLeft", false);
+		m_equipInterval = static_cast<std::uint32_t>(std::max(reader.GetLongValue(SECT_NPC, "EquipInterval", 250), 0l));
+		m_equipCooldown = static_cast<std::uint32_t>(std::max(reader.GetLongValue(SECT_NPC, "EquipCooldown", 1000), 0l));
+
+		m_equipScore.m_damage      = static_cast<float>(reader.GetDoubleValue(SECT_NPC, "ScoreDamage", 1.0));
+		m_equipScore.m_speed       = static_cast<float>(reader.GetDoubleValue(SECT_NPC, "ScoreSpeed", 0.0));
+		m_equipScore.m_reach       = static_cast<float>(reader.GetDoubleValue(SECT_NPC, "ScoreReach", 0.0));
+		m_equipScore.m_enchantment = static_cast<float>(reader.GetDoubleValue(SECT_NPC, "ScoreEnchantment", 0.0));
+		m_equipScore.m_skill       = static_cast<float>(reader.GetDoubleValue(SECT_NPC, "ScoreSkill", 0.0));
 
 		return (m_loaded = reader.is_loaded());
 	}
 
+	void Config::CopyStartupOptions(const Config& a_from)
+	{
+		m_disableWeapNodeSharing = a_from.m_disableWeapNodeSharing;
+		m_shieldHandWorkaround   = a_from.m_shieldHandWorkaround;
+		m_shieldToggleKeys       = a_from.m_shieldToggleKeys;
+		m_animEventReattach      = a_from.m_animEventReattach;
+		m_npcEquipLeft           = a_from.m_npcEquipLeft;
+		m_equipScore             = a_from.m_equipScore;
+		m_equipInterval          = a_from.m_equipInterval;
+		m_equipCooldown          = a_from.m_equipCooldown;
+
+		// the patches behind these are only installed if they were enabled on startup,
+		// so they can be turned off here but not on
+		if (!a_from.m_shield.IsEnabled())
+		{
+			m_shield.m_flags.clear(Data::Flags::kEnabled);
+		}
+
+		if (!a_from.m_shieldHideFlags.test_any(Data::Flags::kEnabled))
+		{
+			m_shieldHideFlags.clear(Data::Flags::kEnabled);
+		}
+
+		if (!a_from.HasEnabled2HEntries())
+		{
+			m_2hSword.m_flags.clear(Data::Flags::kEnabled);
+			m_2hAxe.m_flags.clear(Data::Flags::kEnabled);
+		}
+	}
+
 }
\ No newline at end of file
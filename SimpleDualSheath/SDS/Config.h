@@ -49,6 +49,8 @@ namespace SDS
 		inline static constexpr auto SECT_2HSWORD = "2HSword";
 		inline static constexpr auto SECT_2HAXE   = "2HAxe";
 
+		inline static constexpr auto SECT_OVERRIDES = "Overrides";
+
 		inline static constexpr auto KW_FLAGS      = "Flags";
 		inline static constexpr auto KW_SHEATHNODE = "SheathNode";
 
@@ -74,11 +76,35 @@ namespace SDS
 			}
 		};
 
+		// [Overrides] Sections= lists the sections to read these from
+		struct OverrideEntry
+		{
+			std::string              m_name;
+			ConfigEntry              m_config;
+			std::vector<std::string> m_forms;
+			std::vector<std::string> m_keywords;
+			std::vector<std::string> m_races;
+			std::vector<std::string> m_types;
+		};
+
+		struct EquipScoreWeights
+		{
+			float m_damage{ 1.0f };
+			float m_speed{ 0.0f };
+			float m_reach{ 0.0f };
+			float m_enchantment{ 0.0f };
+			float m_skill{ 0.0f };
+		};
+
 		Config() = default;
 		Config(const std::string& a_path);
 
 		bool Load(const std::string& a_path);
 
+		// options that decide what gets installed at startup, a reload can't change them.
+		// a_from has to be the startup config, not one from an earlier reload.
+		void CopyStartupOptions(const Config& a_from);
+
 		[[nodiscard]] inline constexpr bool IsLoaded() const noexcept
 		{
 			return m_loaded;
@@ -99,11 +125,21 @@ namespace SDS
 		ConfigEntry m_2hAxe;
 		ConfigEntry m_shield;
 
+		std::vector<OverrideEntry> m_overrides;
+
 		bool m_disableScabbards{ false };
 		bool m_npcEquipLeft{ false };
 		bool m_shieldHandWorkaround{ false };
 		bool m_shwForceIfDrawn{ false };
 		bool m_disableWeapNodeSharing{ false };
+		bool m_watchConfigFile{ false };
+		bool m_animEventReattach{ false };
+
+		std::uint32_t m_updateBudget{ 1000 };
+
+		EquipScoreWeights m_equipScore;
+		std::uint32_t     m_equipInterval{ 250 };
+		std::uint32_t     m_equipCooldown{ 1000 };
 
 		ConfigKeyCombo m_shieldToggleKeys;
 
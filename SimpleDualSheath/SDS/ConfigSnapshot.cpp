@@ -0,0 +1,36 @@
+#include "pch.h"
+
+#include "ConfigSnapshot.h"
+
+namespace SDS
+{
+	using namespace Data;
+
+	ConfigSnapshot::ConfigSnapshot(const Config& a_conf) :
+		conf(a_conf)
+	{
+	}
+
+	void ConfigSnapshot::Compile()
+	{
+		data = std::make_unique<WeaponData>();
+
+		data->Create(WEAPON_TYPE::kOneHandSword, StringHolder::NINODE_SWORD, StringHolder::NINODE_SWORD_LEFT, conf.m_sword);
+		data->Create(WEAPON_TYPE::kOneHandAxe, StringHolder::NINODE_AXE, StringHolder::NINODE_AXE_LEFT, conf.m_axe);
+		data->Create(WEAPON_TYPE::kOneHandMace, StringHolder::NINODE_MACE, StringHolder::NINODE_MACE_LEFT, conf.m_mace);
+		data->Create(WEAPON_TYPE::kOneHandDagger, StringHolder::NINODE_DAGGER, StringHolder::NINODE_DAGGER_LEFT, conf.m_dagger);
+		data->Create(WEAPON_TYPE::kStaff, StringHolder::NINODE_STAFF, StringHolder::NINODE_STAFF_LEFT, conf.m_staff);
+		data->Create(WEAPON_TYPE::kTwoHandSword, StringHolder::NINODE_WEAPON_BACK, StringHolder::NINODE_SWORD_ON_BACK_LEFT, conf.m_2hSword);
+		data->Create(WEAPON_TYPE::kTwoHandAxe, StringHolder::NINODE_WEAPON_BACK, StringHolder::NINODE_AXE_ON_BACK_LEFT, conf.m_2hAxe);
+
+		attachments.Compile(*data, conf.m_overrides);
+
+#ifdef _SDS_DEBUG
+		attachments.Benchmark(*data);
+#endif
+
+		shieldSheathNode = conf.m_shield.m_sheathNode.empty() ?
+		                       StringHolder::NINODE_SHIELD_BACK :
+		                       conf.m_shield.m_sheathNode.c_str();
+	}
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "Config.h"
+#include "Data.h"
+#include "StringHolder.h"
+
+namespace SDS
+{
+	// everything derived from the ini, never modified once published
+	struct ConfigSnapshot
+	{
+		explicit ConfigSnapshot(const Config& a_conf);
+
+		ConfigSnapshot(const ConfigSnapshot&)            = delete;
+		ConfigSnapshot& operator=(const ConfigSnapshot&) = delete;
+
+		// needs game data
+		void Compile();
+
+		const Config conf;
+
+		std::unique_ptr<Data::WeaponData> data;
+		Data::AttachmentTable             attachments;
+		BSFixedString                     shieldSheathNode;
+	};
+}
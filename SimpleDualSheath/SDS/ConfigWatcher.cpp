@@ -0,0 +1,113 @@
+#include "pch.h"
+
+#include "ConfigWatcher.h"
+
+namespace SDS
+{
+	ConfigWatcher::ConfigWatcher(
+		const std::string& a_path,
+		func_type          a_func) :
+		m_path(a_path),
+		m_func(std::move(a_func))
+	{
+		const auto pos = m_path.find_last_of("\\/");
+
+		m_directory = pos != std::string::npos ?
+		                  m_path.substr(0, pos) :
+		                  ".";
+	}
+
+	ConfigWatcher::~ConfigWatcher()
+	{
+		if (m_thread.joinable())
+		{
+			::SetEvent(m_stopEvent);
+			m_thread.join();
+		}
+
+		if (m_stopEvent)
+		{
+			::CloseHandle(m_stopEvent);
+		}
+	}
+
+	bool ConfigWatcher::Start()
+	{
+		m_stopEvent = ::CreateEventA(nullptr, TRUE, FALSE, nullptr);
+		if (!m_stopEvent)
+		{
+			return false;
+		}
+
+		m_thread = std::thread([this] { Run(); });
+
+		return true;
+	}
+
+	bool ConfigWatcher::GetWriteTime(FILETIME& a_out) const
+	{
+		WIN32_FILE_ATTRIBUTE_DATA data;
+		if (!::GetFileAttributesExA(m_path.c_str(), GetFileExInfoStandard, std::addressof(data)))
+		{
+			return false;
+		}
+
+		a_out = data.ftLastWriteTime;
+
+		return true;
+	}
+
+	void ConfigWatcher::Run()
+	{
+		const auto change = ::FindFirstChangeNotificationA(
+			m_directory.c_str(),
+			FALSE,
+			FILE_NOTIFY_CHANGE_LAST_WRITE);
+
+		if (change == INVALID_HANDLE_VALUE)
+		{
+			gLog.Error("%s: could not watch '%s' (%lu)", __FUNCTION__, m_directory.c_str(), ::GetLastError());
+			return;
+		}
+
+		FILETIME last{};
+		GetWriteTime(last);
+
+		const HANDLE handles[] = { m_stopEvent, change };
+
+		for (;;)
+		{
+			const auto r = ::WaitForMultipleObjects(
+				static_cast<DWORD>(std::size(handles)),
+				handles,
+				FALSE,
+				INFINITE);
+
+			if (r != WAIT_OBJECT_0 + 1)
+			{
+				break;
+			}
+
+			// editors tend to write more than once
+			if (::WaitForSingleObject(m_stopEvent, 250) == WAIT_OBJECT_0)
+			{
+				break;
+			}
+
+			FILETIME current;
+			if (GetWriteTime(current) &&
+			    ::CompareFileTime(std::addressof(current), std::addressof(last)) != 0)
+			{
+				last = current;
+				m_func();
+			}
+
+			if (!::FindNextChangeNotification(change))
+			{
+				break;
+			}
+		}
+
+		::FindCloseChangeNotification(change);
+	}
+}
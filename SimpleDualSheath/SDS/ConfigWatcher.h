@@ -0,0 +1,31 @@
+#pragma once
+
+namespace SDS
+{
+	// calls back (on its own thread) whenever the file's last write time changes
+	class ConfigWatcher
+	{
+	public:
+		using func_type = std::function<void()>;
+
+		ConfigWatcher(const std::string& a_path, func_type a_func);
+		~ConfigWatcher();
+
+		ConfigWatcher(const ConfigWatcher&)            = delete;
+		ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+		bool Start();
+
+	private:
+		void Run();
+
+		[[nodiscard]] bool GetWriteTime(FILETIME& a_out) const;
+
+		std::string m_path;
+		std::string m_directory;
+		func_type   m_func;
+
+		HANDLE      m_stopEvent{ nullptr };
+		std::thread m_thread;
+	};
+}
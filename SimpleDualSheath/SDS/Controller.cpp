@@ -17,28 +17,71 @@ namespace SDS
 
 	Controller::Controller(
 		const Config& a_conf) :
-		m_conf(a_conf),
 		m_shieldOnBackSwitch(1)
 	{
+		// not compiled until data is loaded
+		Publish(std::make_unique<ConfigSnapshot>(a_conf));
+	}
+
+	void Controller::Publish(std::unique_ptr<ConfigSnapshot>&& a_snapshot)
+	{
+		IScopedLock lock(m_snapshotLock);
+
+		m_snapshot.store(a_snapshot.get(), std::memory_order_release);
+		m_snapshots.emplace_back(std::move(a_snapshot));
+	}
+
+	void Controller::ReloadConfig()
+	{
+		Config conf(PLUGIN_INI_FILE_NOEXT);
+		if (!conf.IsLoaded())
+		{
+			gLog.Warning("Unable to reload the configuration file");
+			return;
+		}
+
+		{
+			IScopedLock lock(m_snapshotLock);
+
+			// the first one is what the patches were installed for
+			conf.CopyStartupOptions(m_snapshots.front()->conf);
+		}
+
+		auto snapshot = std::make_unique<ConfigSnapshot>(conf);
+		snapshot->Compile();
+
+		Publish(std::move(snapshot));
+
+		m_shieldState.Clear();
+		m_fingerprints.Clear();
+
+		gLog.Message("Configuration reloaded");
+
+		EvaluateDrawnStateOnNearbyActors(UpdateReason::kReload);
 	}
 
 	void Controller::InitializeData()
 	{
+		// plugin messages are dispatched on the main thread
+		m_mainThreadId = ::GetCurrentThreadId();
+
 		m_strings = stl::make_smart<StringHolder>();
 
-		m_data = std::make_unique<WeaponData>();
+		auto snapshot = std::make_unique<ConfigSnapshot>(GetConfig());
+		snapshot->Compile();
+
+		Publish(std::move(snapshot));
 
-		m_data->Create(WEAPON_TYPE::kOneHandSword, StringHolder::NINODE_SWORD, StringHolder::NINODE_SWORD_LEFT, m_conf.m_sword);
-		m_data->Create(WEAPON_TYPE::kOneHandAxe, StringHolder::NINODE_AXE, StringHolder::NINODE_AXE_LEFT, m_conf.m_axe);
-		m_data->Create(WEAPON_TYPE::kOneHandMace, StringHolder::NINODE_MACE, StringHolder::NINODE_MACE_LEFT, m_conf.m_mace);
-		m_data->Create(WEAPON_TYPE::kOneHandDagger, StringHolder::NINODE_DAGGER, StringHolder::NINODE_DAGGER_LEFT, m_conf.m_dagger);
-		m_data->Create(WEAPON_TYPE::kStaff, StringHolder::NINODE_STAFF, StringHolder::NINODE_STAFF_LEFT, m_conf.m_staff);
-		m_data->Create(WEAPON_TYPE::kTwoHandSword, StringHolder::NINODE_WEAPON_BACK, StringHolder::NINODE_SWORD_ON_BACK_LEFT, m_conf.m_2hSword);
-		m_data->Create(WEAPON_TYPE::kTwoHandAxe, StringHolder::NINODE_WEAPON_BACK, StringHolder::NINODE_AXE_ON_BACK_LEFT, m_conf.m_2hAxe);
+		const auto& conf = GetConfig();
 
-		if (!m_conf.m_shield.m_sheathNode.empty())
+		m_weaponNodeNames.Populate();
+
+		if (conf.m_npcEquipLeft)
 		{
-			m_strings->m_shieldSheathNode = m_conf.m_shield.m_sheathNode.c_str();
+			m_weaponScores.Populate(conf.m_equipScore);
+
+			m_equipInterval = std::chrono::milliseconds(conf.m_equipInterval);
+			m_equipCooldown = std::chrono::milliseconds(conf.m_equipCooldown);
 		}
 
 #ifdef _SDS_UNUSED
@@ -47,19 +90,28 @@ namespace SDS
 	}
 
 	bool Controller::GetParentNodes(
-		const Data::Weapon* a_entry,
-		NiNode*             a_root,
-		bool                a_left,
-		NiNode*&            a_sheathedNode,
-		NiNode*&            a_drawnNode) const
+		Actor*               a_actor,
+		const BSFixedString& a_sheathNodeName,
+		std::uint32_t        a_rootIndex,
+		NiNode*              a_root,
+		bool                 a_left,
+		NiNode*&             a_sheathedNode,
+		NiNode*&             a_drawnNode) const
 	{
-		const auto nodea = a_entry->GetNode(a_root, a_left);
+		const auto nodea = m_nodeCache.GetNode(
+			a_actor,
+			a_rootIndex,
+			a_root,
+			a_sheathNodeName);
+
 		if (!nodea)
 		{
 			return false;
 		}
 
-		const auto nodeb = GetNodeByName(
+		const auto nodeb = m_nodeCache.GetNode(
+			a_actor,
+			a_rootIndex,
 			a_root,
 			a_left ?
 				m_strings->m_shield :
@@ -113,18 +165,23 @@ namespace SDS
 		const NiRootNodes&   a_roots,
 		const TESObjectWEAP* a_weapon,
 		bool                 a_drawn,
-		bool                 a_left) const
+		bool                 a_left,
+		bool                 a_relocate,
+		AttachPlan&          a_plan) const
 	{
-		const auto entry = m_data->Get(a_actor, a_weapon, a_left);
-		if (!entry)
+		const auto row = GetSnapshot().attachments.GetRow(a_actor, a_weapon);
+		if (!row)
 		{
 			return;
 		}
 
-		char buf[1024];
-		a_weapon->GetNodeName(buf);
+		const bool isPlayer = a_actor == *g_thePlayer;
+
+		const auto& weaponNodeName = m_weaponNodeNames.Get(a_weapon);
 
-		const BSFixedString weaponNodeName(buf);
+		const auto slot = a_left ?
+		                      NodeCache::ObjectSlot::kWeaponLeft :
+		                      NodeCache::ObjectSlot::kWeaponRight;
 
 		for (std::uint32_t i = 0; i < std::size(a_roots.m_nodes); i++)
 		{
@@ -135,43 +192,138 @@ namespace SDS
 				continue;
 			}
 
-			if (i == 1 && !entry->FirstPerson())
+			const auto sheathNodeName = row->Get(a_left, isPlayer, i == 1);
+			if (!sheathNodeName)
 			{
 				continue;
 			}
 
 			NiNode *sheathedNode, *drawnNode;
-			if (!GetParentNodes(entry, root, a_left, sheathedNode, drawnNode))
+			if (!GetParentNodes(a_actor, *sheathNodeName, i, root, a_left, sheathedNode, drawnNode))
 			{
+				a_plan.complete = false;
 				continue;
 			}
 
 			auto sourceNode = a_drawn ? sheathedNode : drawnNode;
 			auto targetNode = a_drawn ? drawnNode : sheathedNode;
 
-			if (auto w1 = FindChildObject(sourceNode, weaponNodeName))
+			auto object = m_nodeCache.GetAttachedObject(
+				a_actor,
+				i,
+				root,
+				slot,
+				weaponNodeName,
+				sourceNode,
+				targetNode,
+				a_relocate);
+
+			if (!object)
 			{
-				AttachToNode(w1, targetNode);
-				w1->SetVisible(true);
+				object = FindChildObject(sourceNode, weaponNodeName);
+				if (!object)
+				{
+					object = FindChildObject(targetNode, weaponNodeName);
+				}
+
+				if (!object)
+				{
+					a_plan.complete = false;
+					continue;
+				}
+
+				m_nodeCache.SetAttachedObject(a_actor, i, root, slot, object);
 			}
-			else if (auto w2 = FindChildObject(targetNode, weaponNodeName))
+
+			a_plan.Add(object, targetNode, true);
+		}
+	}
+
+	void Controller::AttachPlan::Add(
+		NiAVObject* a_object,
+		NiNode*     a_target,
+		bool        a_show) noexcept
+	{
+		if (count < MAX_OPS)
+		{
+			ops[count++] = { a_object, a_target, a_show };
+		}
+	}
+
+	void Controller::AttachPlan::Apply() const
+	{
+		for (std::uint32_t i = 0; i < count; i++)
+		{
+			auto& e = ops[i];
+
+			AttachToNode(e.object, e.target);
+
+			if (e.show)
 			{
-				w2->SetVisible(true);
+				e.object->SetVisible(true);
 			}
 		}
 	}
 
-	void Controller::ProcessWeaponDrawnChange(
+	auto Controller::MakeFingerprint(
+		Actor*                     a_actor,
+		const ActorProcessManager* a_pm,
+		const NiRootNodes&         a_roots,
+		bool                       a_drawn) const
+		-> ActorFingerprintCache::Fingerprint
+	{
+		ActorFingerprintCache::Fingerprint result;
+
+		if (const auto form = a_pm->equippedObject[ActorProcessManager::kEquippedHand_Left])
+		{
+			result.left = form->formID;
+		}
+
+		if (const auto form = a_pm->equippedObject[ActorProcessManager::kEquippedHand_Right])
+		{
+			result.right = form->formID;
+		}
+
+		result.root3p = a_roots.m_nodes[0];
+		result.root1p = a_roots.m_nodes[1];
+		result.drawn  = a_drawn;
+		result.toggle = GetShieldOnBackSwitch(a_actor);
+
+		return result;
+	}
+
+	bool Controller::ProcessWeaponDrawnChange(
 		Actor* a_actor,
-		bool   a_drawn) const
+		bool   a_drawn,
+		bool   a_relocate,
+		bool   a_force) const
 	{
 		const auto* const pm = a_actor->processManager;
 		if (!pm)
 		{
-			return;
+			return true;
 		}
 
 		NiRootNodes roots(a_actor);
+
+		// before the roots are swapped for the NPC roots
+		const auto fingerprint = MakeFingerprint(a_actor, pm, roots, a_drawn);
+
+		if (!a_force &&
+		    !a_relocate &&
+		    !m_fingerprints.Changed(a_actor->formID, fingerprint))
+		{
+			// same equipment, state and skeletons as the last complete run, everything is where we left it
+			return true;
+		}
+
+		using clock_type = std::chrono::steady_clock;
+
+		const auto planStart = clock_type::now();
+
+		// everything up to the plan only reads
+		AttachPlan plan;
+
 		roots.GetNPCRoots(m_strings->m_npcroot);
 
 		const auto* form = pm->equippedObject[ActorProcessManager::kEquippedHand_Left];
@@ -179,14 +331,14 @@ namespace SDS
 		{
 			if (form->IsWeapon())
 			{
-				ProcessEquippedWeapon(a_actor, roots, static_cast<const TESObjectWEAP*>(form), a_drawn, true);
+				ProcessEquippedWeapon(a_actor, roots, static_cast<const TESObjectWEAP*>(form), a_drawn, true, a_relocate, plan);
 			}
 			else if (form->IsArmor())
 			{
 				const auto armor = static_cast<const TESObjectARMO*>(form);
-				if (armor->IsShield() && m_conf.m_shield.IsEnabled())
+				if (armor->IsShield() && GetConfig().m_shield.IsEnabled())
 				{
-					ProcessEquippedShield(a_actor, roots, a_drawn, GetShieldOnBackSwitch(a_actor));
+					ProcessEquippedShield(a_actor, roots, a_drawn, GetShieldOnBackSwitch(a_actor), plan);
 				}
 			}
 		}
@@ -196,38 +348,436 @@ namespace SDS
 		{
 			if (const auto weapon = form->As<TESObjectWEAP>())
 			{
-				ProcessEquippedWeapon(a_actor, roots, weapon, a_drawn, false);
+				ProcessEquippedWeapon(a_actor, roots, weapon, a_drawn, false, a_relocate, plan);
 			}
 		}
+
+		const auto applyStart = clock_type::now();
+
+		plan.Apply();
+
+		const auto end = clock_type::now();
+
+		// something wasn't there yet (weapon 3D not attached after a load etc.), don't skip the next one
+		if (plan.complete)
+		{
+			m_fingerprints.Set(a_actor->formID, fingerprint);
+		}
+		else
+		{
+			m_fingerprints.Invalidate(a_actor->formID);
+		}
+
+		m_planTime += static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(applyStart - planStart).count());
+		m_applyTime += static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - applyStart).count());
+		m_planCount++;
+
+		return plan.complete;
+	}
+
+	bool Controller::ProcessUpdate(
+		Actor*               a_actor,
+		const PendingUpdate& a_update) const
+	{
+		const auto& conf = GetConfig();
+
+		// graphs are rebuilt along with the 3D, adding an existing sink is a no-op
+		if (conf.m_animEventReattach &&
+		    a_update.reasons.test_any(
+				UpdateReason::kLoad |
+				UpdateReason::kInitScript |
+				UpdateReason::kNearby |
+				UpdateReason::kRaceSwitch |
+				UpdateReason::kNiNodeUpdate))
+		{
+			RegisterAnimationEventSink(a_actor);
+		}
+
+#ifdef _SDS_UNUSED
+		if (a_update.reasons.test(UpdateReason::kLoad))
+		{
+			m_nodeOverride->ApplyNodeOverrides(a_actor);
+		}
+#endif
+
+		// anything that can move nodes or change the rules without changing the fingerprint
+		const bool force = a_update.reasons.test_any(
+			UpdateReason::kLoad |
+			UpdateReason::kRaceSwitch |
+			UpdateReason::kNiNodeUpdate |
+			UpdateReason::kEquipSlot |
+			UpdateReason::kReload);
+
+		const bool complete = ProcessWeaponDrawnChange(
+			a_actor,
+			GetIsDrawn(a_actor, a_update.drawnState),
+			a_update.reasons.test(UpdateReason::kReload),
+			force);
+
+		if (a_update.reasons.test_any(UpdateReason::kLoad | UpdateReason::kInitScript) &&
+		    conf.m_npcEquipLeft &&
+		    ActorQualifiesForEquip(a_actor))
+		{
+			QueueEvaluateEquip(a_actor);
+		}
+
+		const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now() - a_update.queued).count();
+
+		m_updateLatencyTotal += static_cast<std::uint64_t>(latency);
+		m_updateLatencyCount++;
+
+		if (latency > m_updateLatencyMax)
+		{
+			m_updateLatencyMax = latency;
+		}
+
+		return complete;
 	}
 
-	void Controller::QueueProcessWeaponDrawnChange(
-		TESObjectREFR* a_actor,
-		DrawnState     a_drawnState) const
-	{
-		ITaskPool::QueueLoadedActorTask(
-			a_actor,
-			[this, a_drawnState](
-				Actor* a_actor,
-				Game::ActorHandle) {
-				ProcessWeaponDrawnChange(
-					a_actor,
-					GetIsDrawn(a_actor, a_drawnState));
-			});
+	bool Controller::ProcessOrQueueWeaponDrawnChange(
+		TESObjectREFR* a_actor,
+		DrawnState     a_drawnState,
+		UpdateReason   a_reason) const
+	{
+		if (!a_actor)
+		{
+			return false;
+		}
+
+		// TESInitScriptEvent sends every scripted reference
+		const auto actor = a_actor->As<Actor>();
+		if (!actor)
+		{
+			return false;
+		}
+
+		// the weapon 3D isn't attached yet when these fire, leave them to the pending pass
+		const bool defer =
+			a_reason == UpdateReason::kLoad ||
+			a_reason == UpdateReason::kInitScript;
+
+		// task callbacks and some event sources run on other threads
+		if (!defer && IsMainThread())
+		{
+			if (IsREFRValid(actor))
+			{
+				bool process;
+
+				{
+					IScopedLock lock(m_pendingLock);
+
+					// something is already queued for this actor, merge into it so the order is kept
+					process = !m_pending.contains(actor->formID);
+
+					if (process)
+					{
+						m_updatesInline++;
+					}
+				}
+
+				if (process)
+				{
+					PendingUpdate update;
+
+					update.drawnState = a_drawnState;
+					update.reasons.set(a_reason);
+					update.queued = std::chrono::steady_clock::now();
+
+					const bool complete = ProcessUpdate(actor, update);
+
+					const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+						std::chrono::steady_clock::now() - update.queued).count();
+
+					{
+						IScopedLock lock(m_pendingLock);
+
+						// shares the per-frame budget with the pending pass
+						m_frameUpdateTime += elapsed;
+						m_frameUpdatesProcessed++;
+
+						ScheduleCloseUpdateFrame();
+					}
+
+					if (!complete)
+					{
+						// try again from the pending pass
+						QueueProcessWeaponDrawnChange(actor, a_drawnState, a_reason);
+					}
+
+					return true;
+				}
+			}
+		}
+
+		QueueProcessWeaponDrawnChange(actor, a_drawnState, a_reason);
+
+		return false;
+	}
+
+	void Controller::QueueProcessWeaponDrawnChange(
+		TESObjectREFR* a_actor,
+		DrawnState     a_drawnState,
+		UpdateReason   a_reason) const
+	{
+		if (!a_actor)
+		{
+			return;
+		}
+
+		bool schedule;
+
+		{
+			IScopedLock lock(m_pendingLock);
+
+			auto r = m_pending.try_emplace(a_actor->formID);
+			auto& entry = r.first->second;
+
+			if (r.second)
+			{
+				entry.queued = std::chrono::steady_clock::now();
+				m_updatesQueued++;
+			}
+			else
+			{
+				m_updatesCoalesced++;
+			}
+
+			// an explicit state from a later event wins
+			if (a_drawnState != DrawnState::Determine)
+			{
+				entry.drawnState = a_drawnState;
+			}
+
+			entry.reasons.set(a_reason);
+
+			schedule           = !m_pendingScheduled;
+			m_pendingScheduled = true;
+		}
+
+		if (schedule)
+		{
+			ITaskPool::AddTask([this] {
+				ProcessPendingUpdates();
+			});
+		}
+	}
+
+	void Controller::RequeuePendingUpdate(
+		Game::FormID         a_actor,
+		const PendingUpdate& a_update) const
+	{
+		auto r = m_pending.try_emplace(a_actor, a_update);
+		if (!r.second)
+		{
+			// something new came in since, its drawn state takes precedence
+			auto& entry = r.first->second;
+
+			if (entry.drawnState == DrawnState::Determine)
+			{
+				entry.drawnState = a_update.drawnState;
+			}
+
+			entry.reasons.set(a_update.reasons);
+		}
+	}
+
+	void Controller::ProcessPendingUpdates() const
+	{
+		using clock_type = std::chrono::steady_clock;
+
+		struct Item
+		{
+			float                priority;
+			Actor*               actor;
+			Game::FormID         formid;
+			const PendingUpdate* update;
+		};
+
+		decltype(m_pending) pending;
+
+		{
+			IScopedLock lock(m_pendingLock);
+
+			pending.swap(m_pending);
+			m_pendingScheduled = false;
+
+			if (!pending.empty())
+			{
+				ScheduleCloseUpdateFrame();
+			}
+		}
+
+		if (pending.empty())
+		{
+			return;
+		}
+
+		const auto start = clock_type::now();
+
+		stl::vector<Item> items;
+		items.reserve(pending.size());
+
+		const auto player = *g_thePlayer;
+
+		NiPoint3   cameraPos;
+		const bool hasCamera = GetCameraPosition(cameraPos);
+
+		for (auto& [formid, entry] : pending)
+		{
+			const auto actor = formid.As<Actor>();
+			if (!IsREFRValid(actor))
+			{
+				continue;
+			}
+
+			float priority;
+
+			if (actor == player)
+			{
+				priority = -1.0f;
+			}
+			else if (hasCamera)
+			{
+				const auto dx = actor->pos.x - cameraPos.x;
+				const auto dy = actor->pos.y - cameraPos.y;
+				const auto dz = actor->pos.z - cameraPos.z;
+
+				priority = dx * dx + dy * dy + dz * dz;
+			}
+			else
+			{
+				priority = 0.0f;
+			}
+
+			items.push_back({ priority, actor, formid, std::addressof(entry) });
+		}
+
+		std::sort(
+			items.begin(),
+			items.end(),
+			[](auto& a_lhs, auto& a_rhs) {
+				return a_lhs.priority < a_rhs.priority;
+			});
+
+		const auto budget = static_cast<long long>(GetConfig().m_updateBudget);
+
+		// the budget is per frame, shared with any other pass that ran before this one
+		const auto spent = m_frameUpdateTime;
+
+		stl::vector<std::size_t> incomplete;
+
+		std::size_t i = 0;
+
+		for (; i < items.size(); i++)
+		{
+			// always make progress
+			if ((i > 0 || spent > 0) && budget > 0)
+			{
+				const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(clock_type::now() - start).count();
+				if (spent + elapsed >= budget)
+				{
+					break;
+				}
+			}
+
+			const auto& e = items[i];
+
+			if (!ProcessUpdate(e.actor, *e.update) &&
+			    e.update->retries < MAX_UPDATE_RETRIES)
+			{
+				incomplete.push_back(i);
+			}
+		}
+
+		if (i < items.size() || !incomplete.empty())
+		{
+			bool schedule;
+
+			{
+				IScopedLock lock(m_pendingLock);
+
+				for (auto j : incomplete)
+				{
+					auto update = *items[j].update;
+					update.retries++;
+
+					RequeuePendingUpdate(items[j].formid, update);
+				}
+
+				m_updatesRetried += incomplete.size();
+
+				for (auto j = i; j < items.size(); j++)
+				{
+					RequeuePendingUpdate(items[j].formid, *items[j].update);
+				}
+
+				m_updatesDeferred += items.size() - i;
+
+				schedule           = !m_pendingScheduled;
+				m_pendingScheduled = true;
+			}
+
+			if (schedule)
+			{
+				ITaskPool::AddTask([this] {
+					ProcessPendingUpdates();
+				});
+			}
+		}
+
+		m_frameUpdateTime += std::chrono::duration_cast<std::chrono::microseconds>(clock_type::now() - start).count();
+		m_frameUpdatePasses++;
+		m_frameUpdatesProcessed += i;
+	}
+
+	void Controller::ScheduleCloseUpdateFrame() const
+	{
+		// m_pendingLock is held
+		if (!m_frameCloseScheduled)
+		{
+			// tasks queued from here run next frame, ahead of any pass scheduled after this
+			m_frameCloseScheduled = true;
+
+			ITaskPool::AddTask([this] {
+				CloseUpdateFrame();
+			});
+		}
+	}
+
+	void Controller::CloseUpdateFrame() const
+	{
+		IScopedLock lock(m_pendingLock);
+
+		m_frameCloseScheduled = false;
+
+		if (m_frameUpdateTime > m_maxUpdateFrameTime)
+		{
+			m_maxUpdateFrameTime = m_frameUpdateTime;
+
+			gLog.Debug(
+				"Worst-case update frame: %lld us (%u passes, %zu processed)",
+				m_frameUpdateTime,
+				m_frameUpdatePasses,
+				m_frameUpdatesProcessed);
+		}
+
+		m_frameUpdateTime       = 0;
+		m_frameUpdatePasses     = 0;
+		m_frameUpdatesProcessed = 0;
 	}
 
 	bool Controller::IsShieldEnabled(Actor* a_actor) const
 	{
-		return a_actor == *g_thePlayer ?
-		           m_conf.m_shield.m_flags.test(Flags::kPlayer) :
-		           m_conf.m_shield.m_flags.test(Flags::kNPC);
+		return IsShieldEnabled(a_actor == *g_thePlayer);
 	}
 
 	bool Controller::IsShieldEnabled(bool a_player) const
 	{
-		return a_player ?
-		           m_conf.m_shield.m_flags.test(Flags::kPlayer) :
-		           m_conf.m_shield.m_flags.test(Flags::kNPC);
+		return GetConfig().m_shield.m_flags.test(
+			a_player ?
+				Flags::kPlayer :
+				Flags::kNPC);
 	}
 
 	bool Controller::GetShieldOnBackSwitch(Actor* a_actor) const
@@ -240,24 +790,87 @@ namespace SDS
 		return m_shieldOnBackSwitch.load(std::memory_order_acquire) != 0;
 	}
 
+	auto Controller::ComputeShieldState(Actor* a_actor) const
+		-> stl::flag<ShieldStateCache::State>
+	{
+		using State = ShieldStateCache::State;
+
+		stl::flag<State> result{ State::kNone };
+
+		if (IsShieldEnabled(a_actor))
+		{
+			result.set(State::kEnabled);
+		}
+
+		if (GetShieldOnBackSwitch(a_actor))
+		{
+			result.set(State::kSwitch);
+		}
+
+		if (IsShieldEquipped(a_actor))
+		{
+			result.set(State::kEquipped);
+		}
+
+		return result;
+	}
+
+	auto Controller::RefreshShieldState(Actor* a_actor) const
+		-> stl::flag<ShieldStateCache::State>
+	{
+		const auto result = ComputeShieldState(a_actor);
+
+		m_shieldState.Set(a_actor->formID, result);
+
+		return result;
+	}
+
+	auto Controller::GetShieldState(Actor* a_actor) const
+		-> stl::flag<ShieldStateCache::State>
+	{
+		stl::flag<ShieldStateCache::State> result{ ShieldStateCache::State::kNone };
+
+		if (!m_shieldState.Get(a_actor->formID, result))
+		{
+			return RefreshShieldState(a_actor);
+		}
+
+#ifdef _SDS_DEBUG
+		using State = ShieldStateCache::State;
+
+		const auto current = ComputeShieldState(a_actor);
+
+		if (current.test(State::kEnabled) != result.test(State::kEnabled) ||
+		    current.test(State::kSwitch) != result.test(State::kSwitch) ||
+		    current.test(State::kEquipped) != result.test(State::kEquipped))
+		{
+			gLog.Warning("%s: stale shield state (%p)", __FUNCTION__, a_actor);
+		}
+#endif
+
+		return result;
+	}
+
 	bool Controller::ShouldBlockShieldHide(Actor* a_actor) const
 	{
+		const auto& conf = GetConfig();
+
 		if (a_actor == *g_thePlayer)
 		{
-			if (!m_conf.m_shieldHideFlags.test(Flags::kPlayer))
+			if (!conf.m_shieldHideFlags.test(Flags::kPlayer))
 			{
 				return false;
 			}
 		}
 		else
 		{
-			if (!m_conf.m_shieldHideFlags.test(Flags::kNPC))
+			if (!conf.m_shieldHideFlags.test(Flags::kNPC))
 			{
 				return false;
 			}
 		}
 
-		if (m_conf.m_shieldHideFlags.test(Flags::kMountOnly))
+		if (conf.m_shieldHideFlags.test(Flags::kMountOnly))
 		{
 			return a_actor->flags2.test(Actor::Flags2::kGettingOnOffMount) ||
 			       a_actor->IsOnMount();
@@ -270,7 +883,8 @@ namespace SDS
 		Actor*             a_actor,
 		const NiRootNodes& a_roots,
 		bool               a_drawn,
-		bool               a_switch) const
+		bool               a_switch,
+		AttachPlan&        a_plan) const
 	{
 		if (!IsShieldEnabled(a_actor))
 		{
@@ -283,6 +897,8 @@ namespace SDS
 			return;
 		}
 
+		const auto& snapshot = GetSnapshot();
+
 		for (std::size_t i = 0; i < std::size(a_roots.m_nodes); i++)
 		{
 			auto& root = a_roots.m_nodes[i];
@@ -294,7 +910,7 @@ namespace SDS
 
 			bool firstPerson = (i == 1);
 
-			if (firstPerson && !m_conf.m_shield.FirstPerson())
+			if (firstPerson && !snapshot.conf.m_shield.FirstPerson())
 			{
 				continue;
 			}
@@ -327,20 +943,27 @@ namespace SDS
 			auto& armorNode = data.object;
 			if (!armorNode)
 			{
+				a_plan.complete = false;
 				continue;
 			}
 
 			const auto& targetNodeName = (a_drawn || !a_switch) ?
 			                                 m_strings->m_shield :
-			                                 m_strings->m_shieldSheathNode;
+			                                 snapshot.shieldSheathNode;
+
+			auto targetNode = m_nodeCache.GetNode(
+				a_actor,
+				static_cast<std::uint32_t>(i),
+				root,
+				targetNodeName);
 
-			auto targetNode = GetNodeByName(root, targetNodeName);
 			if (!targetNode)
 			{
+				a_plan.complete = false;
 				continue;
 			}
 
-			AttachToNode(armorNode, targetNode);
+			a_plan.Add(armorNode, targetNode, false);
 		}
 	}
 
@@ -350,13 +973,8 @@ namespace SDS
 		NiNode*        a_root,
 		bool           a_is1p) const
 	{
-		auto entry = m_data->Get(a_actor, a_weapon, true);
-		if (!entry)
-		{
-			return nullptr;
-		}
-
-		if (a_is1p && !entry->FirstPerson())
+		const auto name = GetSnapshot().attachments.Get(a_actor, a_weapon, true, a_is1p);
+		if (!name)
 		{
 			return nullptr;
 		}
@@ -371,12 +989,16 @@ namespace SDS
 			}
 		}
 
-		return entry->GetNode(root, true);
+		return m_nodeCache.GetNode(
+			a_actor,
+			0,
+			root,
+			*name);
 	}
 
-	const BSFixedString* Controller::GetScbAttachmentNodeName(NiNode*, TESObjectWEAP* a_form) const
+	const BSFixedString* Controller::GetScbAttachmentNodeName(Actor* a_actor, TESObjectWEAP* a_form) const
 	{
-		return m_data->GetNodeName(a_form, true);
+		return GetSnapshot().attachments.GetLeftNodeName(a_actor, a_form);
 	}
 
 	const BSFixedString* Controller::GetWeaponAttachmentNodeName(
@@ -385,18 +1007,7 @@ namespace SDS
 		bool           a_is1p,
 		bool           a_left) const
 	{
-		auto entry = m_data->Get(a_actor, a_weapon, a_left);
-		if (!entry)
-		{
-			return nullptr;
-		}
-
-		if (a_is1p && !entry->FirstPerson())
-		{
-			return nullptr;
-		}
-
-		return std::addressof(entry->GetNodeName(a_left));
+		return GetSnapshot().attachments.Get(a_actor, a_weapon, a_left, a_is1p);
 	}
 
 	const BSFixedString* Controller::GetShieldAttachmentNodeName(
@@ -424,27 +1035,39 @@ namespace SDS
 			return nullptr;
 		}
 
-		if (a_is1p && !m_conf.m_shield.FirstPerson())
+		const auto& snapshot = GetSnapshot();
+
+		if (a_is1p && !snapshot.conf.m_shield.FirstPerson())
 		{
 			return nullptr;
 		}
 
-		return std::addressof(m_strings->m_shieldSheathNode);
+		return std::addressof(snapshot.shieldSheathNode);
 	}
 
-	void Controller::OnActorLoad(TESObjectREFR* a_actor) const
+	void Controller::OnActorLoad(
+		TESObjectREFR* a_actor,
+		UpdateReason   a_reason) const
 	{
-		ITaskPool::QueueLoadedActorTask(a_actor, [this](Actor* a_actor, Game::ActorHandle) {
-#ifdef _SDS_UNUSED
-			m_nodeOverride->ApplyNodeOverrides(a_actor);
-#endif
-			ProcessWeaponDrawnChange(a_actor, a_actor->IsWeaponDrawn());
+		if (a_actor)
+		{
+			m_nodeCache.Invalidate(a_actor->formID);
+			InvalidateDualWield(a_actor->formID);
+		}
 
-			if (m_conf.m_npcEquipLeft && ActorQualifiesForEquip(a_actor))
-			{
-				EvaluateEquip(a_actor);
-			}
-		});
+		ProcessOrQueueWeaponDrawnChange(
+			a_actor,
+			DrawnState::Determine,
+			a_reason);
+	}
+
+	void Controller::OnActorUnload(TESObjectREFR* a_actor) const
+	{
+		m_nodeCache.Invalidate(a_actor->formID);
+		m_shieldState.Invalidate(a_actor->formID);
+		m_fingerprints.Invalidate(a_actor->formID);
+		InvalidateDualWield(a_actor->formID);
+		DropEquipIndex(a_actor->formID);
 	}
 
 #ifdef _SDS_UNUSED
@@ -462,11 +1085,18 @@ namespace SDS
 		BSTEventSource<TESObjectLoadedEvent>*)
 		-> EventResult
 	{
-		if (a_evn && a_evn->loaded)
+		if (a_evn)
 		{
 			if (auto actor = a_evn->formId.As<Actor>())
 			{
-				OnActorLoad(actor);
+				if (a_evn->loaded)
+				{
+					OnActorLoad(actor, UpdateReason::kLoad);
+				}
+				else
+				{
+					OnActorUnload(actor);
+				}
 			}
 		}
 
@@ -480,7 +1110,8 @@ namespace SDS
 	{
 		if (a_evn)
 		{
-			OnActorLoad(a_evn->reference);
+			// repeats for references that are already loaded, left to the fingerprint check
+			OnActorLoad(a_evn->reference, UpdateReason::kInitScript);
 		}
 
 		return EventResult::kContinue;
@@ -488,7 +1119,7 @@ namespace SDS
 
 	void Controller::OnWeaponEquip(Actor* a_actor, const TESObjectWEAP* a_weapon)
 	{
-		if (!m_conf.m_npcEquipLeft)
+		if (!GetConfig().m_npcEquipLeft)
 		{
 			return;
 		}
@@ -520,13 +1151,20 @@ namespace SDS
 		BSTEventSource<TESEquipEvent>*)
 		-> EventResult
 	{
-		if (a_evn && a_evn->equipped && a_evn->actor)
+		if (a_evn && a_evn->actor)
 		{
 			if (const auto actor = a_evn->actor->As<Actor>())
 			{
-				if (const auto weapon = a_evn->baseObject.As<TESObjectWEAP>())
+				if (a_evn->baseObject.As<TESObjectARMO>())
+				{
+					m_shieldState.Invalidate(actor->formID);
+				}
+				else if (a_evn->equipped)
 				{
-					OnWeaponEquip(actor, weapon);
+					if (const auto weapon = a_evn->baseObject.As<TESObjectWEAP>())
+					{
+						OnWeaponEquip(actor, weapon);
+					}
 				}
 			}
 		}
@@ -539,11 +1177,15 @@ namespace SDS
 		BSTEventSource<TESSwitchRaceCompleteEvent>*)
 		-> EventResult
 	{
-		if (a_evn)
+		if (a_evn && a_evn->refr)
 		{
-			QueueProcessWeaponDrawnChange(
+			m_nodeCache.Invalidate(a_evn->refr->formID);
+			InvalidateDualWield(a_evn->refr->formID);
+
+			ProcessOrQueueWeaponDrawnChange(
 				a_evn->refr,
-				DrawnState::Determine);
+				DrawnState::Determine,
+				UpdateReason::kRaceSwitch);
 		}
 
 		return EventResult::kContinue;
@@ -554,11 +1196,46 @@ namespace SDS
 		BSTEventSource<SKSENiNodeUpdateEvent>*)
 		-> EventResult
 	{
-		if (a_evn)
+		// nothing to work with until data is loaded
+		if (!m_strings)
 		{
-			QueueProcessWeaponDrawnChange(
-				a_evn->reference,
-				DrawnState::Determine);
+			return EventResult::kContinue;
+		}
+
+		if (a_evn && a_evn->reference)
+		{
+			const auto actor = a_evn->reference->As<Actor>();
+			if (!actor)
+			{
+				return EventResult::kContinue;
+			}
+
+			// cheap, and the skeleton may have changed in ways the fingerprint doesn't see
+			// (nodes added by RaceMenu etc.), also drops what we didn't find before
+			m_nodeCache.Invalidate(actor->formID);
+
+			// fired a lot (RaceMenu, outfit and morph updates), no need to reattach unless equipment,
+			// drawn state, the toggle or the root nodes changed since we last ran
+			if (actor->processManager)
+			{
+				NiRootNodes roots(actor);
+
+				const auto fingerprint = MakeFingerprint(
+					actor,
+					actor->processManager,
+					roots,
+					actor->IsWeaponDrawn());
+
+				if (!m_fingerprints.Changed(actor->formID, fingerprint))
+				{
+					return EventResult::kContinue;
+				}
+			}
+
+			ProcessOrQueueWeaponDrawnChange(
+				actor,
+				DrawnState::Determine,
+				UpdateReason::kNiNodeUpdate);
 
 #ifdef _SDS_UNUSED
 			OnNiNodeUpdate(a_evn->reference);
@@ -578,10 +1255,10 @@ namespace SDS
 			switch (a_evn->type)
 			{
 			case SKSEActionEvent::Type::kEndDraw:
-				QueueProcessWeaponDrawnChange(a_evn->actor, DrawnState::Drawn);
+				ProcessOrQueueWeaponDrawnChange(a_evn->actor, DrawnState::Drawn, UpdateReason::kDrawSheathe);
 				break;
 			case SKSEActionEvent::Type::kEndSheathe:
-				QueueProcessWeaponDrawnChange(a_evn->actor, DrawnState::Sheathed);
+				ProcessOrQueueWeaponDrawnChange(a_evn->actor, DrawnState::Sheathed, UpdateReason::kDrawSheathe);
 				break;
 			}
 		}
@@ -589,15 +1266,139 @@ namespace SDS
 		return EventResult::kContinue;
 	}
 
-	void Controller::EvaluateDrawnStateOnNearbyActors()
+	bool Controller::IsHighProcess(Actor* a_actor)
+	{
+		if (a_actor == *g_thePlayer)
+		{
+			return true;
+		}
+
+		auto pl = Game::ProcessLists::GetSingleton();
+		if (!pl)
+		{
+			return false;
+		}
+
+		for (const auto& handle : pl->highActorHandles)
+		{
+			if (!handle || !handle.IsValid())
+			{
+				continue;
+			}
+
+			NiPointer<Actor> actor;
+
+			if (handle.Lookup(actor) && actor == a_actor)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void Controller::RegisterAnimationEventSink(Actor* a_actor) const
+	{
+		// graphs of actors further out barely update, the action events still cover them
+		if (!IsHighProcess(a_actor))
+		{
+			return;
+		}
+
+		BSTSmartPointer<RE::BSAnimationGraphManager> manager;
+		if (!a_actor->animGraphHolder.GetAnimationGraphManagerImpl(manager) || !manager)
+		{
+			return;
+		}
+
+		const auto sink = static_cast<BSTEventSink<RE::BSAnimationGraphEvent>*>(const_cast<Controller*>(this));
+
+		for (auto& e : manager->graphs)
+		{
+			if (e)
+			{
+				static_cast<BSTEventSource<RE::BSAnimationGraphEvent>*>(e.get())->AddEventSink(sink);
+			}
+		}
+	}
+
+	auto Controller::ReceiveEvent(
+		const RE::BSAnimationGraphEvent* a_evn,
+		BSTEventSource<RE::BSAnimationGraphEvent>*)
+		-> EventResult
+	{
+		using clock_type = std::chrono::steady_clock;
+
+		if (!a_evn || !a_evn->holder)
+		{
+			return EventResult::kContinue;
+		}
+
+		bool drawn;
+
+		if (a_evn->tag == m_strings->m_weaponDraw)
+		{
+			drawn = true;
+		}
+		else if (a_evn->tag == m_strings->m_weaponSheathe)
+		{
+			drawn = false;
+		}
+		else
+		{
+			return EventResult::kContinue;
+		}
+
+		const auto actor = const_cast<TESObjectREFR*>(a_evn->holder)->As<Actor>();
+		if (!actor)
+		{
+			return EventResult::kContinue;
+		}
+
+		// graphs are also updated from job threads, the scene graph can only be touched here
+		if (!IsMainThread())
+		{
+			m_animEventsQueued.fetch_add(1, std::memory_order_relaxed);
+
+			QueueProcessWeaponDrawnChange(
+				actor,
+				drawn ? DrawnState::Drawn : DrawnState::Sheathed,
+				UpdateReason::kDrawSheathe);
+
+			return EventResult::kContinue;
+		}
+
+		const auto start = clock_type::now();
+
+		// merges into whatever is already pending for the actor so a queued update can't undo this one
+		if (ProcessOrQueueWeaponDrawnChange(
+				actor,
+				drawn ? DrawnState::Drawn : DrawnState::Sheathed,
+				UpdateReason::kDrawSheathe))
+		{
+			const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(clock_type::now() - start).count();
+
+			m_animEventsInline.fetch_add(1, std::memory_order_relaxed);
+			m_animApplyTime.fetch_add(static_cast<std::uint64_t>(elapsed), std::memory_order_relaxed);
+		}
+		else
+		{
+			m_animEventsQueued.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		return EventResult::kContinue;
+	}
+
+	void Controller::EvaluateDrawnStateOnNearbyActors(UpdateReason a_reason)
 	{
-		ITaskPool::AddTask([this] {
+		ITaskPool::AddTask([this, a_reason] {
 			if (auto player = *g_thePlayer;
 			    IsREFRValid(player))
 			{
-				ProcessWeaponDrawnChange(
+				QueueProcessWeaponDrawnChange(
 					player,
-					player->IsWeaponDrawn());
+					DrawnState::Determine,
+					a_reason);
 			}
 
 			auto pl = Game::ProcessLists::GetSingleton();
@@ -625,22 +1426,223 @@ namespace SDS
 					continue;
 				}
 
-				ProcessWeaponDrawnChange(
+				QueueProcessWeaponDrawnChange(
 					actor,
-					actor->IsWeaponDrawn());
+					DrawnState::Determine,
+					a_reason);
 			}
 		});
 	}
 
-	void Controller::Receive(const Events::OnSetEquipSlot&)
+	void Controller::ProcessEquipSlotChanges()
+	{
+		decltype(m_equipSlotWeapons) weapons;
+
+		{
+			IScopedLock lock(m_equipSlotLock);
+
+			weapons.swap(m_equipSlotWeapons);
+			m_equipSlotPasses++;
+		}
+
+		const auto func = [&](Actor* a_actor) {
+			const auto* const pm = a_actor->processManager;
+			if (!pm)
+			{
+				return;
+			}
+
+			for (const auto* e : pm->equippedObject)
+			{
+				if (!e || !e->IsWeapon())
+				{
+					continue;
+				}
+
+				if (weapons.contains(static_cast<const TESObjectWEAP*>(e)))
+				{
+					QueueProcessWeaponDrawnChange(
+						a_actor,
+						DrawnState::Determine,
+						UpdateReason::kEquipSlot);
+
+					break;
+				}
+			}
+		};
+
+		if (auto player = *g_thePlayer;
+		    IsREFRValid(player))
+		{
+			func(player);
+		}
+
+		if (auto pl = Game::ProcessLists::GetSingleton())
+		{
+			for (const auto& handle : pl->highActorHandles)
+			{
+				if (!handle || !handle.IsValid())
+				{
+					continue;
+				}
+
+				NiPointer<Actor> actor;
+
+				if (!handle.Lookup(actor))
+				{
+					continue;
+				}
+
+				if (!IsREFRValid(actor))
+				{
+					continue;
+				}
+
+				func(actor);
+			}
+		}
+	}
+
+	void Controller::Receive(const Events::OnSetEquipSlot& a_evn)
 	{
+		if (!a_evn.weapon)
+		{
+			return;
+		}
+
 		auto player = *g_thePlayer;
 		if (!player || !player->loadedState)
 		{
 			return;
 		}
 
-		EvaluateDrawnStateOnNearbyActors();
+		bool schedule;
+
+		{
+			IScopedLock lock(m_equipSlotLock);
+
+			m_equipSlotEvents++;
+
+			// a burst within one frame collapses into a single pass
+			schedule = m_equipSlotWeapons.empty();
+			m_equipSlotWeapons.emplace(a_evn.weapon);
+		}
+
+		if (schedule)
+		{
+			ITaskPool::AddTask([this] {
+				ProcessEquipSlotChanges();
+			});
+		}
+	}
+
+	void Controller::ClearCaches()
+	{
+		m_nodeCache.Clear();
+		m_shieldState.Clear();
+		m_fingerprints.Clear();
+		m_weaponNodeNames.ClearRuntime();
+		ClearEquipIndex();
+		ClearDualWieldCache();
+	}
+
+	void Controller::LogStats() const
+	{
+		const auto nodeStats = m_nodeCache.GetStats();
+
+		gLog.Debug(
+			"Node cache: %zu actors, %llu hits, %llu misses, %llu negative, objects: %llu hits, %llu misses",
+			nodeStats.actors,
+			nodeStats.hits,
+			nodeStats.misses,
+			nodeStats.negativeHits,
+			nodeStats.objectHits,
+			nodeStats.objectMisses);
+
+		{
+			IScopedLock lock(m_pendingLock);
+
+			gLog.Debug(
+				"Drawn state updates: %llu inline, %llu queued, %llu coalesced, %llu deferred, %llu retried, worst frame %lld us",
+				m_updatesInline,
+				m_updatesQueued,
+				m_updatesCoalesced,
+				m_updatesDeferred,
+				m_updatesRetried,
+				m_maxUpdateFrameTime);
+
+			gLog.Debug(
+				"Drawn state latency: avg %llu us, max %lld us (%llu updates)",
+				m_updateLatencyCount ? m_updateLatencyTotal / m_updateLatencyCount : 0,
+				m_updateLatencyMax,
+				m_updateLatencyCount);
+		}
+
+		if (GetConfig().m_animEventReattach)
+		{
+			const auto numInline = m_animEventsInline.load(std::memory_order_relaxed);
+
+			gLog.Debug(
+				"Animation events: %llu applied inline (avg %llu us), %llu queued from other threads",
+				numInline,
+				numInline ? m_animApplyTime.load(std::memory_order_relaxed) / numInline : 0,
+				m_animEventsQueued.load(std::memory_order_relaxed));
+		}
+
+		{
+			IScopedLock lock(m_equipSlotLock);
+
+			gLog.Debug(
+				"Equip slot changes: %llu events, %llu passes",
+				m_equipSlotEvents,
+				m_equipSlotPasses);
+		}
+
+		gLog.Debug(
+			"Dual wield cache: %zu actors",
+			GetDualWieldCacheSize());
+
+		gLog.Debug(
+			"Reparenting: %llu passes, avg plan %llu ns, avg apply %llu ns",
+			m_planCount,
+			m_planCount ? m_planTime / m_planCount : 0,
+			m_planCount ? m_applyTime / m_planCount : 0);
+
+		const auto fingerprintStats = m_fingerprints.GetStats();
+
+		gLog.Debug(
+			"Fingerprints: %zu actors, %llu unchanged, %llu changed",
+			fingerprintStats.actors,
+			fingerprintStats.unchanged,
+			fingerprintStats.changed);
+
+		const auto shieldStats = m_shieldState.GetStats();
+
+		gLog.Debug(
+			"Shield state: %zu actors, %llu hits, %llu misses, %llu not cached (table full)",
+			shieldStats.actors,
+			shieldStats.hits,
+			shieldStats.misses,
+			shieldStats.full);
+
+		const auto equipStats = GetEquipStats();
+
+		gLog.Debug(
+			"Left-hand equip: %llu requests, %llu skipped, %llu deferred, %llu evaluations, %llu passes",
+			equipStats.requests,
+			equipStats.skipped,
+			equipStats.deferred,
+			equipStats.evaluations,
+			equipStats.passes);
+
+		const auto pathStats = m_nodeCache.GetPathTable().GetStats();
+
+		gLog.Debug(
+			"Node paths: %zu skeletons, %llu hits, %llu mismatches, %llu recorded",
+			pathStats.skeletons,
+			pathStats.hits,
+			pathStats.mismatches,
+			pathStats.recorded);
 	}
 
 	void Controller::SaveGameHandler(SKSESerializationInterface* a_intfc)
@@ -669,6 +1671,7 @@ namespace SDS
 					if (a_intfc->ReadRecordData(std::addressof(data), sizeof(data)) == sizeof(data))
 					{
 						m_shieldOnBackSwitch.store(data.shieldOnBackSwitch, std::memory_order_acquire);
+						m_shieldState.Invalidate((*g_thePlayer)->formID);
 					}
 				}
 				break;
@@ -680,6 +1683,8 @@ namespace SDS
 	{
 		const auto n = m_shieldOnBackSwitch.fetch_xor(1, std::memory_order_acq_rel);
 
+		m_shieldState.Invalidate((*g_thePlayer)->formID);
+
 		const SDSPlayerShieldOnBackSwitchEvent evn{ !static_cast<bool>(n) };
 		SendEvent(evn);
 
@@ -692,9 +1697,13 @@ namespace SDS
 				const bool drawn = a_actor->IsWeaponDrawn();
 				const bool sw    = GetShieldOnBackSwitch(a_actor);
 
-				ProcessEquippedShield(a_actor, roots, drawn, sw);
+				AttachPlan plan;
+
+				ProcessEquippedShield(a_actor, roots, drawn, sw, plan);
+
+				plan.Apply();
 
-				if (m_conf.m_shieldHandWorkaround &&
+				if (GetConfig().m_shieldHandWorkaround &&
 			        !drawn &&
 			        IsShieldEquipped(a_actor))
 				{
@@ -1,10 +1,15 @@
 #pragma once
 
+#include "ActorFingerprintCache.h"
 #include "Config.h"
+#include "ConfigSnapshot.h"
 #include "Data.h"
 #include "EquipManager.h"
 #include "InputHandler.h"
+#include "NodeCache.h"
+#include "ShieldStateCache.h"
 #include "StringHolder.h"
+#include "WeaponNodeNameTable.h"
 #include "Util/Node.h"
 
 #ifdef _SDS_UNUSED
@@ -32,6 +37,7 @@ namespace SDS
 		public BSTEventSink<TESSwitchRaceCompleteEvent>,
 		public BSTEventSink<SKSENiNodeUpdateEvent>,
 		public BSTEventSink<SKSEActionEvent>,
+		public BSTEventSink<RE::BSAnimationGraphEvent>,
 		public ::Events::EventSink<Events::OnSetEquipSlot>,
 		public ::Events::ThreadSafeEventDispatcher<SDSPlayerShieldOnBackSwitchEvent>
 	{
@@ -57,6 +63,20 @@ namespace SDS
 			Drawn
 		};
 
+		enum class UpdateReason : std::uint32_t
+		{
+			kNone = 0,
+
+			kLoad         = 1u << 0,
+			kDrawSheathe  = 1u << 1,
+			kRaceSwitch   = 1u << 2,
+			kNiNodeUpdate = 1u << 3,
+			kNearby       = 1u << 4,
+			kEquipSlot    = 1u << 5,
+			kReload       = 1u << 6,
+			kInitScript   = 1u << 7,
+		};
+
 		Controller(const Config& a_conf);
 
 		Controller(const Controller&)            = delete;
@@ -66,15 +86,24 @@ namespace SDS
 
 		void                               InitializeData();
 		[[nodiscard]] NiNode*              GetScbAttachmentNode(Actor* a_actor, TESObjectWEAP* a_form, NiNode* a_root, bool a_is1p) const;
-		[[nodiscard]] const BSFixedString* GetScbAttachmentNodeName(NiNode* a_root, TESObjectWEAP* a_form) const;
+		[[nodiscard]] const BSFixedString* GetScbAttachmentNodeName(Actor* a_actor, TESObjectWEAP* a_form) const;
 		[[nodiscard]] const BSFixedString* GetWeaponAttachmentNodeName(Actor* a_actor, TESObjectWEAP* a_form, bool a_is1p, bool a_left) const;
 		[[nodiscard]] const BSFixedString* GetShieldAttachmentNodeName(Actor* a_actor, TESObjectARMO* a_form, bool a_is1p) const;
 
-		[[nodiscard]] inline constexpr const auto& GetConfig() const
+		// lock-free, the returned snapshot stays valid for the lifetime of the controller
+		[[nodiscard]] inline const ConfigSnapshot& GetSnapshot() const noexcept
+		{
+			return *m_snapshot.load(std::memory_order_acquire);
+		}
+
+		[[nodiscard]] inline const Config& GetConfig() const noexcept
 		{
-			return m_conf;
+			return GetSnapshot().conf;
 		}
 
+		// parses the ini again and publishes the result, any thread
+		void ReloadConfig();
+
 		[[nodiscard]] inline const StringHolder* GetStringHolder() const
 		{
 			return m_strings.get();
@@ -87,32 +116,108 @@ namespace SDS
 		[[nodiscard]] bool                ShouldBlockShieldHide(Actor* a_actor) const;
 		[[nodiscard]] static BIPED_OBJECT GetShieldBipedObject(Actor* a_actor);
 
-		void EvaluateDrawnStateOnNearbyActors();
+		// cached, for the clenched hand hooks
+		[[nodiscard]] stl::flag<ShieldStateCache::State> GetShieldState(Actor* a_actor) const;
+		stl::flag<ShieldStateCache::State>               RefreshShieldState(Actor* a_actor) const;
+
+		void EvaluateDrawnStateOnNearbyActors(UpdateReason a_reason = UpdateReason::kNearby);
+
+		void ClearCaches();
+		void LogStats() const;
 
 		// Serialization
 		void SaveGameHandler(SKSESerializationInterface* a_intfc);
 		void LoadGameHandler(SKSESerializationInterface* a_intfc);
 
-		void QueueProcessWeaponDrawnChange(TESObjectREFR* a_actor, DrawnState a_drawnState) const;
+		// always goes through the pending queue (batched, budgeted)
+		void QueueProcessWeaponDrawnChange(TESObjectREFR* a_actor, DrawnState a_drawnState, UpdateReason a_reason) const;
 
 	private:
+		// scene graph edits decided by the planning pass, applied in one go on the main thread.
+		// plain pointers, the plan never outlives the call that built it.
+		struct AttachPlan
+		{
+			struct Op
+			{
+				NiAVObject* object;
+				NiNode*     target;
+				bool        show;
+			};
+
+			// left, right and shield, 3p + 1p each
+			inline static constexpr std::size_t MAX_OPS = 6;
+
+			void Add(NiAVObject* a_object, NiNode* a_target, bool a_show) noexcept;
+			void Apply() const;
+
+			Op            ops[MAX_OPS];
+			std::uint32_t count{ 0 };
+			bool          complete{ true };  // false if a node or object we expected wasn't found
+		};
+
+		struct PendingUpdate
+		{
+			DrawnState                            drawnState{ DrawnState::Determine };
+			stl::flag<UpdateReason>               reasons{ UpdateReason::kNone };
+			std::chrono::steady_clock::time_point queued;  // first event, for latency stats
+			std::uint32_t                         retries{ 0 };  // passes that ran with something missing
+		};
+
+		// weapon 3D can take a few frames to show up after a load
+		inline static constexpr std::uint32_t MAX_UPDATE_RETRIES = 8;
+
+		// for event sinks, applied right away when called on the main thread and the actor's 3D is there,
+		// returns true if it was
+		bool ProcessOrQueueWeaponDrawnChange(TESObjectREFR* a_actor, DrawnState a_drawnState, UpdateReason a_reason) const;
+
+		// returns false if something wasn't there yet
+		bool ProcessUpdate(Actor* a_actor, const PendingUpdate& a_update) const;
+		void ProcessPendingUpdates() const;
+		void ScheduleCloseUpdateFrame() const;
+		void CloseUpdateFrame() const;
+		void RequeuePendingUpdate(Game::FormID a_actor, const PendingUpdate& a_update) const;
+
+		void ProcessEquipSlotChanges();
+
 		[[nodiscard]] bool GetParentNodes(
-			const Data::Weapon* a_entry,
-			NiNode*             a_root,
-			bool                a_left,
-			NiNode*&            a_sheathedNode,
-			NiNode*&            a_drawnNode) const;
+			Actor*               a_actor,
+			const BSFixedString& a_sheathNodeName,
+			std::uint32_t        a_rootIndex,
+			NiNode*              a_root,
+			bool                 a_left,
+			NiNode*&             a_sheathedNode,
+			NiNode*&             a_drawnNode) const;
+
+		void ProcessEquippedWeapon(Actor* a_actor, const ::Util::Node::NiRootNodes& a_roots, const TESObjectWEAP* a_weapon, bool a_drawn, bool a_left, bool a_relocate, AttachPlan& a_plan) const;
+		// returns false if a node or object we expected wasn't there, skipped runs (a_force not set and the
+		// fingerprint matches the last complete run) count as complete
+		bool ProcessWeaponDrawnChange(Actor* a_actor, bool a_drawn, bool a_relocate = false, bool a_force = true) const;
 
-		void ProcessEquippedWeapon(Actor* a_actor, const ::Util::Node::NiRootNodes& a_roots, const TESObjectWEAP* a_weapon, bool a_drawn, bool a_left) const;
-		void ProcessWeaponDrawnChange(Actor* a_actor, bool a_drawn) const;
+		[[nodiscard]] ActorFingerprintCache::Fingerprint MakeFingerprint(
+			Actor*                           a_actor,
+			const ActorProcessManager*       a_pm,
+			const ::Util::Node::NiRootNodes& a_roots,
+			bool                             a_drawn) const;
 
-		void ProcessEquippedShield(Actor* a_actor, const ::Util::Node::NiRootNodes& a_roots, bool a_drawn, bool a_switch) const;
+		void ProcessEquippedShield(Actor* a_actor, const ::Util::Node::NiRootNodes& a_roots, bool a_drawn, bool a_switch, AttachPlan& a_plan) const;
+
+		[[nodiscard]] stl::flag<ShieldStateCache::State> ComputeShieldState(Actor* a_actor) const;
 
 		//[[nodiscard]] NiNode* FindObjectNPCRoot(TESObjectREFR* a_actor, NiAVObject* a_object, bool a_no1p) const;
 
 		[[nodiscard]] static bool GetIsDrawn(Actor* a_actor, DrawnState a_state);
+		[[nodiscard]] static bool IsHighProcess(Actor* a_actor);
+
+		// events can come from worker threads (animation graphs, task callbacks)
+		[[nodiscard]] inline bool IsMainThread() const noexcept
+		{
+			return ::GetCurrentThreadId() == m_mainThreadId;
+		}
+
+		void RegisterAnimationEventSink(Actor* a_actor) const;
 
-		void OnActorLoad(TESObjectREFR* a_actor) const;
+		void OnActorLoad(TESObjectREFR* a_actor, UpdateReason a_reason) const;
+		void OnActorUnload(TESObjectREFR* a_actor) const;
 #ifdef _SDS_UNUSED
 		void OnNiNodeUpdate(TESObjectREFR* a_actor);
 #endif
@@ -128,6 +233,9 @@ namespace SDS
 
 		virtual EventResult ReceiveEvent(const SKSENiNodeUpdateEvent* a_evn, BSTEventSource<SKSENiNodeUpdateEvent>* a_dispatcher) override;
 		virtual EventResult ReceiveEvent(const SKSEActionEvent* a_evn, BSTEventSource<SKSEActionEvent>* a_dispatcher) override;
+
+		// registered per actor, only with AnimationEventReattach
+		virtual EventResult ReceiveEvent(const RE::BSAnimationGraphEvent* a_evn, BSTEventSource<RE::BSAnimationGraphEvent>* a_dispatcher) override;
 		//virtual EventResult	ReceiveEvent(SKSECameraEvent* a_evn, EventDispatcher<SKSECameraEvent>* a_dispatcher) override;
 
 		// EngineExtensions
@@ -135,17 +243,68 @@ namespace SDS
 
 		virtual void OnKeyPressed() override;
 
-		const Config m_conf;
+		void Publish(std::unique_ptr<ConfigSnapshot>&& a_snapshot);
+
+		std::atomic<const ConfigSnapshot*> m_snapshot{ nullptr };
+
+		// old snapshots are never freed since hooks may still be reading them, reloads are rare and manual
+		WCriticalSection                             m_snapshotLock;
+		stl::vector<std::unique_ptr<ConfigSnapshot>> m_snapshots;
 
-		stl::smart_ptr<StringHolder>      m_strings;
-		std::unique_ptr<Data::WeaponData> m_data;
+		stl::smart_ptr<StringHolder> m_strings;
 
 		std::atomic<std::uint8_t> m_shieldOnBackSwitch;
 
+		mutable NodeCache             m_nodeCache;
+		mutable WeaponNodeNameTable   m_weaponNodeNames;
+		mutable ShieldStateCache      m_shieldState;
+		mutable ActorFingerprintCache m_fingerprints;
+
+		mutable WCriticalSection                                m_pendingLock;
+		mutable std::unordered_map<Game::FormID, PendingUpdate> m_pending;
+		mutable bool                                            m_pendingScheduled{ false };
+
+		mutable std::uint64_t m_updatesInline{ 0 };
+		mutable std::uint64_t m_updatesQueued{ 0 };
+		mutable std::uint64_t m_updatesCoalesced{ 0 };
+		mutable std::uint64_t m_updatesDeferred{ 0 };
+		mutable std::uint64_t m_updatesRetried{ 0 };
+
+		// pending update work in the current frame, main thread only
+		mutable long long     m_frameUpdateTime{ 0 };
+		mutable std::uint32_t m_frameUpdatePasses{ 0 };
+		mutable std::size_t   m_frameUpdatesProcessed{ 0 };
+		mutable bool          m_frameCloseScheduled{ false };
+
+		mutable long long m_maxUpdateFrameTime{ 0 };
+
+		// ProcessWeaponDrawnChange, decisions/lookups vs. scene graph writes (ns)
+		mutable std::uint64_t m_planTime{ 0 };
+		mutable std::uint64_t m_applyTime{ 0 };
+		mutable std::uint64_t m_planCount{ 0 };
+
+		// event to reparent, in us
+		mutable std::uint64_t m_updateLatencyTotal{ 0 };
+		mutable std::uint64_t m_updateLatencyCount{ 0 };
+		mutable long long     m_updateLatencyMax{ 0 };
+
+		std::atomic<std::uint64_t> m_animEventsInline{ 0 };
+		std::atomic<std::uint64_t> m_animEventsQueued{ 0 };
+		std::atomic<std::uint64_t> m_animApplyTime{ 0 };
+
+		DWORD m_mainThreadId{ 0 };
+
+		WCriticalSection                          m_equipSlotLock;
+		std::unordered_set<const TESObjectWEAP*> m_equipSlotWeapons;
+		std::uint64_t                             m_equipSlotEvents{ 0 };
+		std::uint64_t                             m_equipSlotPasses{ 0 };
+
 		//mutable WCriticalSection m_lock;
 
 #ifdef _SDS_UNUSED
 		std::unique_ptr<NodeOverride> m_nodeOverride;
 #endif
 	};
+
+	DEFINE_ENUM_CLASS_BITWISE(Controller::UpdateReason);
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "Config.h"
 #include "Data.h"
+#include "Util/Common.h"
 #include "Util/Node.h"
 
 #include <ext/Node.h>
@@ -122,6 +123,467 @@ namespace SDS
 			return nullptr;
 		}
 
+		static std::uint32_t ParseWeaponType(const std::string& a_name)
+		{
+			// same names as the per-type sections
+			constexpr std::pair<const char*, WEAPON_TYPE> types[] = {
+				{ Config::SECT_SWORD, WEAPON_TYPE::kOneHandSword },
+				{ Config::SECT_AXE, WEAPON_TYPE::kOneHandAxe },
+				{ Config::SECT_MACE, WEAPON_TYPE::kOneHandMace },
+				{ Config::SECT_DAGGER, WEAPON_TYPE::kOneHandDagger },
+				{ Config::SECT_STAFF, WEAPON_TYPE::kStaff },
+				{ Config::SECT_2HSWORD, WEAPON_TYPE::kTwoHandSword },
+				{ Config::SECT_2HAXE, WEAPON_TYPE::kTwoHandAxe }
+			};
+
+			for (auto& e : types)
+			{
+				if (_stricmp(e.first, a_name.c_str()) == 0)
+				{
+					return stl::underlying(e.second);
+				}
+			}
+
+			return WeaponData::NUM_TYPES;
+		}
+
+		void AttachmentTable::CompileRow(
+			const Weapon* a_entry,
+			Row&          a_out)
+		{
+			for (std::uint32_t left = 0; left < 2; left++)
+			{
+				for (std::uint32_t player = 0; player < 2; player++)
+				{
+					for (std::uint32_t is1p = 0; is1p < 2; is1p++)
+					{
+						auto& cell = a_out.cells[left][player][is1p];
+
+						cell = nullptr;
+
+						if (!a_entry)
+						{
+							continue;
+						}
+
+						if (!a_entry->m_flags.test(player ? Flags::kPlayer : Flags::kNPC))
+						{
+							continue;
+						}
+
+						if (!left && !a_entry->m_flags.test(Flags::kRight))
+						{
+							continue;
+						}
+
+						if (is1p && !a_entry->FirstPerson())
+						{
+							continue;
+						}
+
+						cell = std::addressof(a_entry->GetNodeName(left != 0));
+					}
+				}
+			}
+		}
+
+		void AttachmentTable::Compile(
+			const WeaponData&                         a_data,
+			const std::vector<Config::OverrideEntry>& a_overrides)
+		{
+			for (std::uint32_t type = 0; type < WeaponData::NUM_TYPES; type++)
+			{
+				const auto entry = a_data.GetEntry(type);
+
+				m_leftNames[type] = entry ?
+				                        std::addressof(entry->GetNodeName(true)) :
+				                        nullptr;
+
+				CompileRow(entry, m_rows[type]);
+			}
+
+			ResolveOverrides(a_data, a_overrides);
+
+			for (const auto& e : m_rows)
+			{
+				UpdateHasAny(e);
+			}
+
+			for (const auto& e : m_overrideRows)
+			{
+				UpdateHasAny(e.row);
+			}
+
+			gLog.Debug(
+				"Attachment table: %zu override rows, %zu forms, %zu races, ~%zu bytes",
+				m_overrideRows.size(),
+				m_forms.size(),
+				m_races.size(),
+				GetMemoryUsage());
+		}
+
+		void AttachmentTable::UpdateHasAny(const Row& a_row) noexcept
+		{
+			for (std::uint32_t left = 0; left < 2; left++)
+			{
+				for (const auto& e : a_row.cells[left])
+				{
+					for (const auto cell : e)
+					{
+						if (cell)
+						{
+							m_hasAny[left] = true;
+						}
+					}
+				}
+			}
+		}
+
+		std::uint32_t AttachmentTable::AddOverride(
+			const Weapon&              a_base,
+			const Config::ConfigEntry& a_config)
+		{
+			auto& entry = m_overrideEntries.emplace_back(std::make_unique<Weapon>(a_base));
+
+			entry->m_flags = a_config.m_flags;
+
+			// not user settable
+			if (a_base.m_flags.test(Flags::kRight))
+			{
+				entry->m_flags.set(Flags::kRight);
+			}
+
+			if (a_base.m_flags.test(Flags::kSwap))
+			{
+				entry->m_flags.set(Flags::kSwap);
+			}
+
+			if (!a_config.m_sheathNode.empty())
+			{
+				entry->m_nodeNameLeft = a_config.m_sheathNode.c_str();
+			}
+
+			auto& row = m_overrideRows.emplace_back();
+
+			CompileRow(entry.get(), row.row);
+			row.leftName = std::addressof(entry->GetNodeName(true));
+
+			return static_cast<std::uint32_t>(m_overrideRows.size() - 1);
+		}
+
+		void AttachmentTable::ResolveOverrides(
+			const WeaponData&                         a_data,
+			const std::vector<Config::OverrideEntry>& a_overrides)
+		{
+			m_overrideRows.clear();
+			m_overrideEntries.clear();
+			m_forms.clear();
+			m_races.clear();
+
+			if (a_overrides.empty())
+			{
+				return;
+			}
+
+			auto dh = DataHandler::GetSingleton();
+			if (!dh)
+			{
+				return;
+			}
+
+			for (auto& e : a_overrides)
+			{
+				// rows are per weapon type since the drawn side node depends on it
+				std::uint32_t rows[WeaponData::NUM_TYPES];
+				std::fill(std::begin(rows), std::end(rows), NO_OVERRIDE);
+
+				auto getRow = [&](std::uint32_t a_type) {
+					auto& r = rows[a_type];
+					if (r == NO_OVERRIDE)
+					{
+						if (auto base = a_data.GetEntry(a_type))
+						{
+							r = AddOverride(*base, e.m_config);
+						}
+					}
+					return r;
+				};
+
+				std::size_t numForms = 0;
+				std::size_t numRaces = 0;
+
+				auto addWeapon = [&](const TESObjectWEAP* a_weapon) {
+					const auto type = stl::underlying(a_weapon->type());
+					if (type >= WeaponData::NUM_TYPES)
+					{
+						return;
+					}
+
+					const auto r = getRow(type);
+					if (r == NO_OVERRIDE)
+					{
+						return;
+					}
+
+					// first matching section wins
+					if (m_forms.try_emplace(a_weapon->formID, r).second)
+					{
+						numForms++;
+					}
+				};
+
+				for (auto& f : e.m_forms)
+				{
+					const auto form   = Common::LookupFormSpec(f);
+					const auto weapon = form ? form->As<TESObjectWEAP>() : nullptr;
+
+					if (!weapon)
+					{
+						gLog.Warning("[%s] %s: not a weapon", e.m_name.c_str(), f.c_str());
+						continue;
+					}
+
+					addWeapon(weapon);
+				}
+
+				if (!e.m_keywords.empty())
+				{
+					stl::vector<BGSKeyword*> keywords;
+
+					for (auto& k : dh->keywords)
+					{
+						if (!k)
+						{
+							continue;
+						}
+
+						for (auto& f : e.m_keywords)
+						{
+							if (_stricmp(k->keyword.Get(), f.c_str()) == 0)
+							{
+								keywords.emplace_back(k);
+								break;
+							}
+						}
+					}
+
+					if (!keywords.empty())
+					{
+						for (auto& w : dh->weapons)
+						{
+							if (!w)
+							{
+								continue;
+							}
+
+							for (auto& k : keywords)
+							{
+								if (w->HasKeyword(k))
+								{
+									addWeapon(w);
+									break;
+								}
+							}
+						}
+					}
+				}
+
+				for (auto& f : e.m_races)
+				{
+					const auto form = Common::LookupFormSpec(f);
+					const auto race = form ? form->As<TESRace>() : nullptr;
+
+					if (!race)
+					{
+						gLog.Warning("[%s] %s: not a race", e.m_name.c_str(), f.c_str());
+						continue;
+					}
+
+					auto r = m_races.try_emplace(race->formID);
+					if (r.second)
+					{
+						r.first->second.fill(NO_OVERRIDE);
+					}
+
+					for (auto& t : e.m_types)
+					{
+						const auto type = ParseWeaponType(t);
+						if (type >= WeaponData::NUM_TYPES)
+						{
+							gLog.Warning("[%s] %s: unknown weapon type", e.m_name.c_str(), t.c_str());
+							continue;
+						}
+
+						auto& v = r.first->second[type];
+						if (v == NO_OVERRIDE)
+						{
+							v = getRow(type);
+						}
+					}
+
+					numRaces++;
+				}
+
+				gLog.Debug(
+					"Override [%s]: %zu weapons, %zu races",
+					e.m_name.c_str(),
+					numForms,
+					numRaces);
+			}
+		}
+
+		auto AttachmentTable::FindOverride(
+			Actor*               a_actor,
+			const TESObjectWEAP* a_weapon) const
+			-> const OverrideRow*
+		{
+			if (!m_forms.empty())
+			{
+				auto it = m_forms.find(a_weapon->formID);
+				if (it != m_forms.end())
+				{
+					return std::addressof(m_overrideRows[it->second]);
+				}
+			}
+
+			if (a_actor && !m_races.empty())
+			{
+				if (const auto race = a_actor->GetRace())
+				{
+					auto it = m_races.find(race->formID);
+					if (it != m_races.end())
+					{
+						const auto type = stl::underlying(a_weapon->type());
+						if (type < WeaponData::NUM_TYPES)
+						{
+							const auto index = it->second[type];
+							if (index != NO_OVERRIDE)
+							{
+								return std::addressof(m_overrideRows[index]);
+							}
+						}
+					}
+				}
+			}
+
+			return nullptr;
+		}
+
+		auto AttachmentTable::GetRow(
+			Actor*               a_actor,
+			const TESObjectWEAP* a_weapon) const
+			-> const Row*
+		{
+			if (const auto entry = FindOverride(a_actor, a_weapon))
+			{
+				return std::addressof(entry->row);
+			}
+
+			const auto type = stl::underlying(a_weapon->type());
+
+			return type < WeaponData::NUM_TYPES ?
+			           std::addressof(m_rows[type]) :
+			           nullptr;
+		}
+
+		const BSFixedString* AttachmentTable::GetLeftNodeName(
+			Actor*               a_actor,
+			const TESObjectWEAP* a_weapon) const
+		{
+			if (const auto entry = FindOverride(a_actor, a_weapon))
+			{
+				return entry->leftName;
+			}
+
+			const auto type = stl::underlying(a_weapon->type());
+
+			return type < WeaponData::NUM_TYPES ?
+			           m_leftNames[type] :
+			           nullptr;
+		}
+
+		std::size_t AttachmentTable::GetMemoryUsage() const
+		{
+			constexpr auto formNodeSize = sizeof(decltype(m_forms)::value_type) + sizeof(void*) * 2;
+			constexpr auto raceNodeSize = sizeof(decltype(m_races)::value_type) + sizeof(void*) * 2;
+
+			return sizeof(*this) +
+			       m_overrideRows.capacity() * sizeof(OverrideRow) +
+			       m_overrideEntries.size() * sizeof(Weapon) +
+			       m_forms.size() * formNodeSize +
+			       m_forms.bucket_count() * sizeof(void*) * 2 +
+			       m_races.size() * raceNodeSize +
+			       m_races.bucket_count() * sizeof(void*) * 2;
+		}
+
+#ifdef _SDS_DEBUG
+		void AttachmentTable::Benchmark(const WeaponData& a_data) const
+		{
+			using clock_type = std::chrono::steady_clock;
+
+			constexpr std::uint32_t ITERATIONS = 100000;
+
+			// same branches the hooks used to take, minus the form lookups
+			auto legacy = [&](std::uint32_t a_type, bool a_left, bool a_player, bool a_is1p) -> const BSFixedString* {
+				auto entry = a_data.GetEntry(a_type);
+				if (!entry)
+				{
+					return nullptr;
+				}
+
+				if (!entry->m_flags.test(a_player ? Flags::kPlayer : Flags::kNPC))
+				{
+					return nullptr;
+				}
+
+				if (!a_left && !entry->m_flags.test(Flags::kRight))
+				{
+					return nullptr;
+				}
+
+				if (a_is1p && !entry->FirstPerson())
+				{
+					return nullptr;
+				}
+
+				return std::addressof(entry->GetNodeName(a_left));
+			};
+
+			auto run = [&](auto& a_func) {
+				std::uintptr_t sink = 0;
+
+				const auto start = clock_type::now();
+
+				for (std::uint32_t i = 0; i < ITERATIONS; i++)
+				{
+					const auto type = i % WeaponData::NUM_TYPES;
+					const auto bits = i / WeaponData::NUM_TYPES;
+
+					sink += reinterpret_cast<std::uintptr_t>(
+						a_func(type, (bits & 1) != 0, (bits & 2) != 0, (bits & 4) != 0));
+				}
+
+				const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(clock_type::now() - start).count();
+
+				return std::make_pair(elapsed, sink);
+			};
+
+			auto compiled = [&](std::uint32_t a_type, bool a_left, bool a_player, bool a_is1p) {
+				return Get(a_type, a_left, a_player, a_is1p);
+			};
+
+			const auto a = run(legacy);
+			const auto b = run(compiled);
+
+			gLog.Debug(
+				"Attachment lookup (%u iterations): flags %lld us, table %lld us%s",
+				ITERATIONS,
+				a.first,
+				b.first,
+				a.second == b.second ? "" : " (MISMATCH)");
+		}
+#endif
+
 	}
 
 }
\ No newline at end of file
@@ -47,8 +47,134 @@ namespace SDS
 			[[nodiscard]] const Weapon*        Get(Actor* a_actor, const TESObjectWEAP* a_weapon, bool a_left) const;
 			[[nodiscard]] const BSFixedString* GetNodeName(const TESObjectWEAP* a_weapon, bool a_left) const;
 
+			[[nodiscard]] inline constexpr const Weapon* GetEntry(std::uint32_t a_type) const noexcept
+			{
+				return a_type < std::size(m_entries) ? m_entries[a_type].get() : nullptr;
+			}
+
+			inline static constexpr std::uint32_t NUM_TYPES = 10;
+
+		private:
+			std::unique_ptr<Weapon> m_entries[NUM_TYPES];
+		};
+
+		// WeaponData and the configured overrides flattened into the final answer for every
+		// combination the hooks can ask about, one cache line per row
+		class AttachmentTable
+		{
+			inline static constexpr std::uint32_t NO_OVERRIDE = std::numeric_limits<std::uint32_t>::max();
+
+		public:
+			struct alignas(64) Row
+			{
+				const BSFixedString* cells[2][2][2]{};  // [left][player][1p]
+
+				[[nodiscard]] inline constexpr const BSFixedString* Get(
+					bool a_left,
+					bool a_player,
+					bool a_is1p) const noexcept
+				{
+					return cells[a_left][a_player][a_is1p];
+				}
+			};
+
+		private:
+			struct OverrideRow
+			{
+				Row                  row;
+				const BSFixedString* leftName{ nullptr };
+			};
+
+			using race_rows_type = std::array<std::uint32_t, WeaponData::NUM_TYPES>;
+
+		public:
+			AttachmentTable() = default;
+
+			AttachmentTable(const AttachmentTable&)            = delete;
+			AttachmentTable& operator=(const AttachmentTable&) = delete;
+
+			void Compile(
+				const WeaponData&                         a_data,
+				const std::vector<Config::OverrideEntry>& a_overrides);
+
+			[[nodiscard]] inline constexpr const BSFixedString* Get(
+				std::uint32_t a_type,
+				bool          a_left,
+				bool          a_player,
+				bool          a_is1p) const noexcept
+			{
+				return a_type < WeaponData::NUM_TYPES ?
+				           m_rows[a_type].Get(a_left, a_player, a_is1p) :
+				           nullptr;
+			}
+
+			// form override, then race override, then the weapon type
+			[[nodiscard]] const Row* GetRow(
+				Actor*               a_actor,
+				const TESObjectWEAP* a_weapon) const;
+
+			[[nodiscard]] inline const BSFixedString* Get(
+				Actor*               a_actor,
+				const TESObjectWEAP* a_weapon,
+				bool                 a_left,
+				bool                 a_is1p) const
+			{
+				const auto row = GetRow(a_actor, a_weapon);
+
+				return row ?
+				           row->Get(a_left, a_actor == *g_thePlayer, a_is1p) :
+				           nullptr;
+			}
+
+			// left sheath node regardless of flags, used when cleaning up scabbards (actor may be null)
+			[[nodiscard]] const BSFixedString* GetLeftNodeName(
+				Actor*               a_actor,
+				const TESObjectWEAP* a_weapon) const;
+
+			// false if no row (including overrides) ever yields a node for this side
+			[[nodiscard]] inline constexpr bool HasAny(bool a_left) const noexcept
+			{
+				return m_hasAny[a_left];
+			}
+
+			// whether lookups depend on the actor's race at all
+			[[nodiscard]] inline bool HasRaceOverrides() const noexcept
+			{
+				return !m_races.empty();
+			}
+
+			[[nodiscard]] std::size_t GetMemoryUsage() const;
+
+#ifdef _SDS_DEBUG
+			void Benchmark(const WeaponData& a_data) const;
+#endif
+
 		private:
-			std::unique_ptr<Weapon> m_entries[10];
+			static void CompileRow(const Weapon* a_entry, Row& a_out);
+
+			void UpdateHasAny(const Row& a_row) noexcept;
+
+			void ResolveOverrides(
+				const WeaponData&                         a_data,
+				const std::vector<Config::OverrideEntry>& a_overrides);
+
+			[[nodiscard]] std::uint32_t AddOverride(
+				const Weapon&              a_base,
+				const Config::ConfigEntry& a_config);
+
+			[[nodiscard]] const OverrideRow* FindOverride(
+				Actor*               a_actor,
+				const TESObjectWEAP* a_weapon) const;
+
+			Row                  m_rows[WeaponData::NUM_TYPES];
+			const BSFixedString* m_leftNames[WeaponData::NUM_TYPES]{};
+			bool                 m_hasAny[2]{};
+
+			// built along with the snapshot that owns the table, never changed once it's published
+			stl::vector<OverrideRow>                         m_overrideRows;
+			stl::vector<std::unique_ptr<Weapon>>             m_overrideEntries;
+			std::unordered_map<Game::FormID, std::uint32_t>  m_forms;
+			std::unordered_map<Game::FormID, race_rows_type> m_races;
 		};
 
 	}
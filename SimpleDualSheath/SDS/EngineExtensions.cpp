@@ -18,6 +18,8 @@ namespace SDS
 
 	std::unique_ptr<EngineExtensions> EngineExtensions::m_Instance;
 
+	thread_local EngineExtensions::BipedContext EngineExtensions::m_bipedContext;
+
 	EngineExtensions::EngineExtensions(
 		const stl::smart_ptr<Controller>& a_controller)
 	{
@@ -74,6 +76,52 @@ namespace SDS
 		}
 	}
 
+	void EngineExtensions::UpdateHookFilter(
+		const ConfigSnapshot& a_snapshot)
+	{
+		const auto& conf = a_snapshot.conf;
+
+		std::uint64_t slots = 0;
+
+		if (conf.m_shield.IsEnabled())
+		{
+			// whatever slot a race uses for shields
+			if (auto dh = DataHandler::GetSingleton())
+			{
+				for (const auto& e : dh->races)
+				{
+					if (!e)
+					{
+						continue;
+					}
+
+					const auto slot = e->data.shieldObject;
+					if (slot < BIPED_OBJECT::kTotal)
+					{
+						slots |= 1ui64 << stl::underlying(slot);
+					}
+				}
+			}
+		}
+
+		if (conf.m_disableWeapNodeSharing)
+		{
+			slots |= 1ui64 << stl::underlying(BIPED_OBJECT::kTwoHandMelee);
+			slots |= 1ui64 << stl::underlying(BIPED_OBJECT::kCrossbow);
+		}
+
+		// read by the stubs without locking, each field is a single aligned store
+		m_hookFilter.defaultSlots = slots;
+		m_hookFilter.left         = a_snapshot.attachments.HasAny(true);
+		m_hookFilter.right        = a_snapshot.attachments.HasAny(false);
+
+		gLog.Debug(
+			"Hook filter: slots %.16llX, left: %hhu, right: %hhu",
+			m_hookFilter.defaultSlots,
+			m_hookFilter.left,
+			m_hookFilter.right);
+	}
+
 	auto EngineExtensions::ValidateMemory(
 		const Config& a_config) -> MemoryValidationFlags
 	{
@@ -172,6 +220,7 @@ namespace SDS
 				JITASM(ISKSE::GetLocalTrampoline())
 			{
 				Xbyak::Label callLabel;
+				Xbyak::Label filterLabel;
 				Xbyak::Label exitContinue;
 				Xbyak::Label exitSkip;
 
@@ -181,6 +230,11 @@ namespace SDS
 				cmp(byte[rbp + 0x6F], 0);
 				je(cont);  // skip if not left
 
+				// no left nodes configured, the hook would return null
+				mov(rcx, ptr[rip + filterLabel]);
+				cmp(byte[rcx + offsetof(HookFilter, left)], 0);
+				je(skip);
+
 				mov(rcx, ptr[rbp + 0x77]);
 				mov(rcx, ptr[rcx]);        // Biped
 				mov(r8, ptr[rbp + 0x5F]);  // root
@@ -225,6 +279,9 @@ namespace SDS
 				L(exitSkip);
 				dq(targetAddr + 0x24);
 
+				L(filterLabel);
+				dq(std::uintptr_t(std::addressof(m_hookFilter)));
+
 				L(callLabel);
 				dq(std::uintptr_t(GetScbAttachmentNode_Hook));
 			}
@@ -365,14 +422,22 @@ namespace SDS
 			Assembly(
 				std::uintptr_t a_targetAddr,
 				std::uintptr_t a_callAddr,
-				std::uintptr_t a_retnNoHiddenOffset) :
+				std::uintptr_t a_retnNoHiddenOffset,
+				std::size_t    a_filterOffset) :
 				JITASM(ISKSE::GetLocalTrampoline())
 			{
 				Xbyak::Label callLabel;
 				Xbyak::Label retnLabel;
 				Xbyak::Label retnNoHiddenLabel;
+				Xbyak::Label filterLabel;
+				Xbyak::Label origLabel;
 
 				Xbyak::Label skipHide;
+				Xbyak::Label passthrough;
+
+				mov(rax, ptr[rip + filterLabel]);
+				cmp(byte[rax + a_filterOffset], 0);
+				je(passthrough);
 
 				sub(rsp, 0x40);
 
@@ -417,12 +482,24 @@ namespace SDS
 
 				jmp(ptr[rip + retnNoHiddenLabel]);
 
+				// what the hook falls back to
+				L(passthrough);
+				mov(r8d, 1);
+				call(ptr[rip + origLabel]);
+				jmp(ptr[rip + retnLabel]);
+
 				L(retnLabel);
 				dq(a_targetAddr + 0x5);
 
 				L(retnNoHiddenLabel);
 				dq(a_targetAddr + a_retnNoHiddenOffset);
 
+				L(filterLabel);
+				dq(std::uintptr_t(std::addressof(m_hookFilter)));
+
+				L(origLabel);
+				dq(std::uintptr_t(GetNodeByName.get()));
+
 				L(callLabel);
 				dq(a_callAddr);
 			}
@@ -431,12 +508,12 @@ namespace SDS
 		LogPatchBegin(__FUNCTION__);
 		{
 			{
-				Assembly code(m_getShieldWeaponSlotNode_a.get(), std::uintptr_t(GetWeaponShieldSlotNode_Hook), IAL::IsAE() ? 0x28 : 0x26);
+				Assembly code(m_getShieldWeaponSlotNode_a.get(), std::uintptr_t(GetWeaponShieldSlotNode_Hook), IAL::IsAE() ? 0x28 : 0x26, offsetof(HookFilter, left));
 				ISKSE::GetBranchTrampoline().Write5Branch(m_getShieldWeaponSlotNode_a.get(), code.get());
 			}
 
 			{
-				Assembly code(m_getStaffSlotNode_a.get(), std::uintptr_t(GetWeaponStaffSlotNode_Hook), IAL::IsAE() ? 0x24 : 0x26);
+				Assembly code(m_getStaffSlotNode_a.get(), std::uintptr_t(GetWeaponStaffSlotNode_Hook), IAL::IsAE() ? 0x24 : 0x26, offsetof(HookFilter, right));
 				ISKSE::GetBranchTrampoline().Write5Branch(m_getStaffSlotNode_a.get(), code.get());
 			}
 		}
@@ -453,6 +530,16 @@ namespace SDS
 			{
 				Xbyak::Label callLabel;
 				Xbyak::Label retnLabel;
+				Xbyak::Label filterLabel;
+				Xbyak::Label origLabel;
+
+				Xbyak::Label passthrough;
+
+				// slots the hook never touches (helmets etc.)
+				mov(r9d, IAL::IsAE() ? r15d : r14d);
+				mov(rax, ptr[rip + filterLabel]);
+				bt(qword[rax + offsetof(HookFilter, defaultSlots)], r9);
+				jnc(passthrough);
 
 				sub(rsp, 0x30);
 
@@ -484,9 +571,21 @@ namespace SDS
 
 				jmp(ptr[rip + retnLabel]);
 
+				// what the hook falls back to
+				L(passthrough);
+				mov(r8d, 1);
+				call(ptr[rip + origLabel]);
+				jmp(ptr[rip + retnLabel]);
+
 				L(retnLabel);
 				dq(a_targetAddr + 0x5);
 
+				L(filterLabel);
+				dq(std::uintptr_t(std::addressof(m_hookFilter)));
+
+				L(origLabel);
+				dq(std::uintptr_t(GetNodeByName.get()));
+
 				L(callLabel);
 				dq(std::uintptr_t(GetSlotNodeDefault_Hook));
 			}
@@ -737,11 +836,9 @@ namespace SDS
 		auto controller = m_Instance->m_controller.get();
 
 		if (a_value == 10 &&
-		    controller->IsShieldEnabled(a_actor) &&
-		    controller->GetShieldOnBackSwitch(a_actor) &&
+		    controller->GetShieldState(a_actor).test(ShieldStateCache::State::kActive) &&
 		    (controller->GetConfig().m_shwForceIfDrawn ||
-		     !a_actor->IsWeaponDrawn()) &&
-		    Common::IsShieldEquipped(a_actor))
+		     !a_actor->IsWeaponDrawn()))
 		{
 			a_value = 0;
 		}
@@ -757,12 +854,11 @@ namespace SDS
 	{
 		auto controller = m_Instance->m_controller.get();
 
+		// equip call site, the left hand just changed so don't trust what's cached
 		if (a_value == 10 &&
-		    controller->IsShieldEnabled(a_actor) &&
-		    controller->GetShieldOnBackSwitch(a_actor) &&
+		    controller->RefreshShieldState(a_actor).test(ShieldStateCache::State::kActive) &&
 		    (controller->GetConfig().m_shwForceIfDrawn ||
-		     !a_actor->IsWeaponDrawn()) &&
-		    Common::IsShieldEquipped(a_actor))
+		     !a_actor->IsWeaponDrawn()))
 		{
 			a_value = 0;
 		}
@@ -779,9 +875,7 @@ namespace SDS
 		auto controller = m_Instance->m_controller.get();
 
 		if ((a_value == 0 || a_value == 10) &&
-		    controller->IsShieldEnabled(a_actor) &&
-		    controller->GetShieldOnBackSwitch(a_actor) &&
-		    Common::IsShieldEquipped(a_actor))
+		    controller->GetShieldState(a_actor).test(ShieldStateCache::State::kActive))
 		{
 			a_holder->SetVariableOnGraphsInt(
 				controller->GetStringHolder()->m_iLeftHandType,
@@ -831,12 +925,23 @@ namespace SDS
 
 	bool EngineExtensions::RemoveWeaponScabbard_Rpl(NiNode* a_node)
 	{
-		bool result = false;
+		if (!a_node)
+		{
+			return true;
+		}
 
-		if (a_node)
+		// no strings until data is loaded
+		if (const auto stringHolder = m_Instance->m_controller->GetStringHolder())
 		{
-			result |= RemoveWeaponScabbardImpl(a_node, "Scb");
-			result |= RemoveWeaponScabbardImpl(a_node, "ScbLeft");
+			auto& cache = m_Instance->m_scbLayouts;
+
+			cache.Remove(a_node, ScabbardLayoutCache::Slot::kScb, stringHolder->m_scb);
+			cache.Remove(a_node, ScabbardLayoutCache::Slot::kScbLeft, stringHolder->m_scbLeft);
+		}
+		else
+		{
+			RemoveWeaponScabbardImpl(a_node, "Scb");
+			RemoveWeaponScabbardImpl(a_node, "ScbLeft");
 		}
 
 		return true;
@@ -847,51 +952,140 @@ namespace SDS
 		// this just writes BGSEquipSlot* @rcx+8, but we call here on the off chance something else hooked it
 		m_Instance->m_TESObjectWEAP_SetEquipSlot_o(a_this, a_slot);
 
-		OnSetEquipSlot evn{};
+		OnSetEquipSlot evn{ static_cast<TESObjectWEAP*>(a_this) };
 		m_Instance->m_dispatchers.m_setEquipSlot.SendEvent(evn);
 	}
 
-	NiNode* EngineExtensions::GetScbAttachmentNode_Hook(
-		Biped*       a_biped,
-		BIPED_OBJECT a_bipedSlot,
-		NiNode*      a_root)
+	bool EngineExtensions::ResolveBipedContext(
+		Biped*                    a_biped,
+		BipedContext&             a_out,
+		NiPointer<TESObjectREFR>& a_ref)
 	{
-		// these checks should never fail
-		if (!a_root || !a_biped || a_bipedSlot >= BIPED_OBJECT::kTotal)
+#ifdef _SDS_DEBUG
+		m_bipedLookups.fetch_add(1, std::memory_order_relaxed);
+#endif
+
+		if (!a_biped->handle.Lookup(a_ref))
 		{
-			return nullptr;
+			return false;
 		}
 
+		const auto actor = a_ref->As<Actor>();
+		if (!actor)
+		{
+			return false;
+		}
+
+		a_out.biped      = a_biped;
+		a_out.handle     = a_biped->handle;
+		a_out.actor      = actor;
+		a_out.shieldSlot = actor->GetShieldBipedObject();
+
+		return true;
+	}
+
+	auto EngineExtensions::BeginBipedContext(Biped* a_biped)
+		-> const BipedContext*
+	{
+		auto& ctx = m_bipedContext;
+
+		ctx.active = false;
+
+		// the actor owns the biped being attached and outlives the sequence, no need to hold a reference
 		NiPointer<TESObjectREFR> ref;
-		if (!a_biped->handle.Lookup(ref))
+		if (!ResolveBipedContext(a_biped, ctx, ref))
 		{
 			return nullptr;
 		}
 
-		auto actor = ref->As<Actor>();
-		if (!actor)
+		ctx.active = true;
+
+		return std::addressof(ctx);
+	}
+
+	auto EngineExtensions::GetBipedContext(Biped* a_biped)
+		-> const BipedContext*
+	{
+		auto& ctx = m_bipedContext;
+
+		// started by the slot node hook of the same attach
+		if (ctx.active && ctx.biped == a_biped && ctx.handle == a_biped->handle)
 		{
-			return nullptr;
+#ifdef _SDS_DEBUG
+			m_bipedReused.fetch_add(1, std::memory_order_relaxed);
+#endif
+			return std::addressof(ctx);
 		}
 
-		auto form = a_biped->get_object(a_bipedSlot).item;
-		if (!form)
+		return BeginBipedContext(a_biped);
+	}
+
+	void EngineExtensions::EndBipedContext() noexcept
+	{
+		auto& ctx = m_bipedContext;
+
+		ctx.active = false;
+		ctx.biped  = nullptr;
+		ctx.actor  = nullptr;
+	}
+
+#ifdef _SDS_DEBUG
+	auto EngineExtensions::GetBipedContextStats() noexcept
+		-> BipedContextStats
+	{
+		return {
+			m_bipedLookups.load(std::memory_order_relaxed),
+			m_bipedReused.load(std::memory_order_relaxed)
+		};
+	}
+
+	auto EngineExtensions::GetScabbardLookupStats() noexcept
+		-> ScabbardLookupStats
+	{
+		return {
+			m_scbLookups.load(std::memory_order_relaxed),
+			m_scbLegacyTime.load(std::memory_order_relaxed),
+			m_scbSingleTime.load(std::memory_order_relaxed)
+		};
+	}
+#endif
+
+	NiNode* EngineExtensions::GetScbAttachmentNode_Hook(
+		Biped*       a_biped,
+		BIPED_OBJECT a_bipedSlot,
+		NiNode*      a_root)
+	{
+		// these checks should never fail
+		if (!a_root || !a_biped || a_bipedSlot >= BIPED_OBJECT::kTotal)
 		{
 			return nullptr;
 		}
 
-		auto weapon = form->As<TESObjectWEAP>();
-		if (!weapon)
+		const auto ctx = GetBipedContext(a_biped);
+		if (!ctx)
 		{
 			return nullptr;
 		}
 
-		return m_Instance->m_controller->GetScbAttachmentNode(
-			actor,
-			weapon,
-			a_root,
-			false  // this hook won't run for 1p
-		);
+		NiNode* result = nullptr;
+
+		if (auto form = a_biped->get_object(a_bipedSlot).item)
+		{
+			if (auto weapon = form->As<TESObjectWEAP>())
+			{
+				result = m_Instance->m_controller->GetScbAttachmentNode(
+					ctx->actor,
+					weapon,
+					a_root,
+					false  // this hook won't run for 1p
+				);
+			}
+		}
+
+		// last hook for this object
+		EndBipedContext();
+
+		return result;
 	}
 
 	NiNode* EngineExtensions::GetScbAttachmentNode_Cleanup_Hook(
@@ -915,8 +1109,21 @@ namespace SDS
 			return nullptr;
 		}
 
+		// runs outside of any attach sequence, and the actor is only needed for race overrides
+		Actor*                   actor = nullptr;
+		NiPointer<TESObjectREFR> ref;
+
+		if (m_Instance->m_controller->GetSnapshot().attachments.HasRaceOverrides())
+		{
+			BipedContext ctx;
+			if (ResolveBipedContext(a_biped, ctx, ref))
+			{
+				actor = ctx.actor;
+			}
+		}
+
 		auto name = m_Instance->m_controller->GetScbAttachmentNodeName(
-			root,
+			actor,
 			weapon);
 
 		if (!name)
@@ -947,6 +1154,12 @@ namespace SDS
 			a_is1p,
 			true);
 
+		// the scabbard hook doesn't run for 1p
+		if (a_is1p)
+		{
+			EndBipedContext();
+		}
+
 		if (str)
 		{
 			if (auto result = GetNodeByName(a_root, *str, true))
@@ -976,6 +1189,9 @@ namespace SDS
 			a_is1p,
 			false);
 
+		// no scabbard hook on this side
+		EndBipedContext();
+
 		if (str)
 		{
 			if (auto result = GetNodeByName(a_root, *str, true))
@@ -998,56 +1214,55 @@ namespace SDS
 		BIPED_OBJECT         a_bipedSlot,
 		bool                 a_is1p)
 	{
+		NiPointer<TESObjectREFR> ref;
+		BipedContext             ctx;
+
 		if (a_biped && a_bipedSlot < BIPED_OBJECT::kTotal)
 		{
-			NiPointer<TESObjectREFR> ref;
-			if (a_biped->handle.Lookup(ref))
+			if (ResolveBipedContext(a_biped, ctx, ref))
 			{
-				if (const auto actor = ref->As<Actor>())
+				if (const auto form = a_biped->get_object(a_bipedSlot).item)
 				{
-					if (const auto form = a_biped->get_object(a_bipedSlot).item)
+					if (ctx.shieldSlot == a_bipedSlot)
 					{
-						if (actor->GetShieldBipedObject() == a_bipedSlot)
+						if (const auto armor = form->As<TESObjectARMO>())
 						{
-							if (const auto armor = form->As<TESObjectARMO>())
+							if (const auto str = m_Instance->m_controller->GetShieldAttachmentNodeName(ctx.actor, armor, a_is1p))
 							{
-								if (const auto str = m_Instance->m_controller->GetShieldAttachmentNodeName(actor, armor, a_is1p))
+								if (const auto result = GetNodeByName(a_root, *str, true))
 								{
-									if (const auto result = GetNodeByName(a_root, *str, true))
-									{
-										return result;
-									}
-									// fall back to the node requested by the game if we find nothing
+									return result;
 								}
+								// fall back to the node requested by the game if we find nothing
 							}
 						}
-						else if (m_Instance->m_controller->GetConfig().m_disableWeapNodeSharing)
+					}
+					else if (m_Instance->m_controller->GetConfig().m_disableWeapNodeSharing)
+					{
+						switch (a_bipedSlot)
 						{
-							switch (a_bipedSlot)
+						case BIPED_OBJECT::kTwoHandMelee:
+							if (const auto weap = form->As<TESObjectWEAP>())
 							{
-							case BIPED_OBJECT::kTwoHandMelee:
-								if (const auto weap = form->As<TESObjectWEAP>())
+								if (weap->type() == WEAPON_TYPE::kTwoHandAxe)
 								{
-									if (weap->type() == WEAPON_TYPE::kTwoHandAxe)
-									{
-										const auto stringHolder = m_Instance->m_controller->GetStringHolder();
+									const auto stringHolder = m_Instance->m_controller->GetStringHolder();
 
-										return GetNodeByName(a_root, stringHolder->m_weaponBackAxeMace, true);
-									}
+									return GetNodeByName(a_root, stringHolder->m_weaponBackAxeMace, true);
 								}
-								break;
-							case BIPED_OBJECT::kCrossbow:
-								if (const auto weap = form->As<TESObjectWEAP>())
+							}
+							break;
+						case BIPED_OBJECT::kCrossbow:
+							if (const auto weap = form->As<TESObjectWEAP>())
+							{
+								if (weap->type() == WEAPON_TYPE::kCrossbow)
 								{
-									if (weap->type() == WEAPON_TYPE::kCrossbow)
-									{
-										const auto stringHolder = m_Instance->m_controller->GetStringHolder();
+									const auto stringHolder = m_Instance->m_controller->GetStringHolder();
 
-										return GetNodeByName(a_root, stringHolder->m_weaponCrossbow, true);
-									}
+									return GetNodeByName(a_root, stringHolder->m_weaponCrossbow, true);
 								}
-								break;
 							}
+							break;
 						}
 					}
 				}
@@ -1065,60 +1280,78 @@ namespace SDS
 	{
 		auto stringHolder = m_Instance->m_controller->GetStringHolder();
 
-		NiPointer scbNode     = GetNodeByName(a_node, a_nodeName, true);
-		NiPointer scbLeftNode = GetNodeByName(a_node, stringHolder->m_scbLeft, true);
+#ifdef _SDS_DEBUG
+		using clock_type = std::chrono::steady_clock;
 
-		auto& config = m_Instance->m_controller->GetConfig();
+		const auto legacyStart = clock_type::now();
 
-		if (config.m_disableScabbards)
-		{
-			bool shrink = false;
+		GetNodeByName(a_node, a_nodeName, true);
+		GetNodeByName(a_node, stringHolder->m_scbLeft, true);
 
-			if (scbNode)
-			{
-				scbNode->m_parent->DetachChild2(scbNode);
-				shrink = true;
-			}
+		const auto singleStart = clock_type::now();
+#endif
 
-			if (scbLeftNode)
-			{
-				scbLeftNode->m_parent->DetachChild2(scbLeftNode);
-				shrink = true;
-			}
+		NiAVObject* scb;
+		NiAVObject* scbLeft;
+
+		Util::Node::FindObjects(a_node, a_nodeName, stringHolder->m_scbLeft, scb, scbLeft);
+
+#ifdef _SDS_DEBUG
+		const auto end = clock_type::now();
+
+		m_scbLookups.fetch_add(1, std::memory_order_relaxed);
+		m_scbLegacyTime.fetch_add(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(singleStart - legacyStart).count()), std::memory_order_relaxed);
+		m_scbSingleTime.fetch_add(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - singleStart).count()), std::memory_order_relaxed);
+#endif
 
-			if (shrink)
+		// keep both alive until we're done, detaching may drop the last reference
+		NiPointer scbNode     = scb;
+		NiPointer scbLeftNode = scbLeft;
+
+		bool shrink = false;
+
+		auto detach = [&](NiAVObject* a_object) {
+			if (a_object && a_object->m_parent)
 			{
-				ShrinkToSize(a_node);
+				a_object->m_parent->DetachChild2(a_object);
+				shrink = true;
 			}
+		};
 
-			return nullptr;
-		}
+		NiAVObject* result;
 
-		if (!a_left || a_is1p)
+		if (m_Instance->m_controller->GetConfig().m_disableScabbards)
 		{
-			if (scbLeftNode && scbLeftNode->m_parent)
-			{
-				scbLeftNode->m_parent->DetachChild2(scbLeftNode);
-				ShrinkToSize(a_node);
-			}
+			detach(scbNode);
+			detach(scbLeftNode);
 
-			return scbNode;
+			result = nullptr;
 		}
+		else if (!a_left || a_is1p)
+		{
+			detach(scbLeftNode);
 
-		if (!scbLeftNode)
+			result = scbNode;
+		}
+		else if (!scbLeftNode)
 		{
-			return scbNode;
+			result = scbNode;
 		}
+		else
+		{
+			detach(scbNode);
 
-		if (scbNode && scbNode->m_parent)
+			scbLeftNode->SetVisible(true);
+
+			result = scbLeftNode;
+		}
+
+		if (shrink)
 		{
-			scbNode->m_parent->DetachChild2(scbNode);
 			ShrinkToSize(a_node);
 		}
 
-		scbLeftNode->SetVisible(true);
-
-		return scbLeftNode;
+		return result;
 	}
 
 	bool EngineExtensions::ShouldBlockShieldHide(
@@ -1138,14 +1371,8 @@ namespace SDS
 			return nullptr;
 		}
 
-		NiPointer<TESObjectREFR> ref;
-		if (!a_biped->handle.Lookup(ref))
-		{
-			return nullptr;
-		}
-
-		auto actor = ref->As<Actor>();
-		if (!actor)
+		const auto ctx = BeginBipedContext(a_biped);
+		if (!ctx)
 		{
 			return nullptr;
 		}
@@ -1167,7 +1394,7 @@ namespace SDS
 			return nullptr;
 		}
 
-		return m_controller->GetWeaponAttachmentNodeName(actor, weapon, a_is1p, a_left);
+		return m_controller->GetWeaponAttachmentNodeName(ctx->actor, weapon, a_is1p, a_left);
 	}
 
 }
\ No newline at end of file
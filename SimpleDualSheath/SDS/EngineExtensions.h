@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Controller.h"
+#include "ScabbardLayoutCache.h"
 
 #include "Events/CreateArmorNodeEvent.h"
 #include "Events/CreateWeaponNodesEvent.h"
@@ -36,6 +37,9 @@ namespace SDS
 		static void                  Initialize(const stl::smart_ptr<Controller>& a_controller);
 		static MemoryValidationFlags ValidateMemory(const Config& a_config);
 
+		// call after a snapshot is published, needs game data
+		static void UpdateHookFilter(const ConfigSnapshot& a_snapshot);
+
 		inline static auto GetSingleton() noexcept
 		{
 			return m_Instance.get();
@@ -46,9 +50,75 @@ namespace SDS
 			return m_dispatchers;
 		}
 
+		[[nodiscard]] inline auto GetScabbardLayoutStats() const
+		{
+			return m_scbLayouts.GetStats();
+		}
+
 		FN_NAMEPROC("EngineExtensions");
 
+#ifdef _SDS_DEBUG
+		struct BipedContextStats
+		{
+			std::uint64_t lookups;  // each one is a refcount increment + decrement
+			std::uint64_t reused;
+		};
+
+		[[nodiscard]] static BipedContextStats GetBipedContextStats() noexcept;
+
+		// GetScabbardNode_Hook, two GetNodeByName searches vs. one traversal on the same models
+		struct ScabbardLookupStats
+		{
+			std::uint64_t calls;
+			std::uint64_t legacyTime;  // ns
+			std::uint64_t singleTime;  // ns
+		};
+
+		[[nodiscard]] static ScabbardLookupStats GetScabbardLookupStats() noexcept;
+#endif
+
 	private:
+		// tested inline by the hook stubs, whatever doesn't pass goes straight to the original call.
+		// everything is enabled until the first snapshot is compiled.
+		struct HookFilter
+		{
+			std::uint64_t defaultSlots{ ~0ui64 };  // bit per BIPED_OBJECT (GetSlotNodeDefault_Hook)
+			std::uint8_t  left{ 1 };               // any left node configured (scabbard and shield slot weapon hooks)
+			std::uint8_t  right{ 1 };              // any right node configured (staff slot hook)
+		};
+
+		static_assert(static_cast<std::uint32_t>(BIPED_OBJECT::kTotal) <= 64);
+
+		inline static HookFilter m_hookFilter;
+
+		// attaching a left hand weapon goes through GetWeaponShieldSlotNode_Hook and then
+		// GetScbAttachmentNode_Hook for the same actor. the first one resolves it, the second
+		// reuses it and ends the sequence (per thread). hooks that run on their own resolve
+		// into a local context instead.
+		struct BipedContext
+		{
+			const Biped*            biped{ nullptr };
+			decltype(Biped::handle) handle;
+			Actor*                  actor{ nullptr };
+			BIPED_OBJECT            shieldSlot{ BIPED_OBJECT::kNone };
+			bool                    active{ false };
+		};
+
+		[[nodiscard]] static bool                ResolveBipedContext(Biped* a_biped, BipedContext& a_out, NiPointer<TESObjectREFR>& a_ref);
+		[[nodiscard]] static const BipedContext* BeginBipedContext(Biped* a_biped);
+		[[nodiscard]] static const BipedContext* GetBipedContext(Biped* a_biped);
+		static void                              EndBipedContext() noexcept;
+
+		static thread_local BipedContext m_bipedContext;
+
+#ifdef _SDS_DEBUG
+		inline static std::atomic<std::uint64_t> m_bipedLookups{ 0 };
+		inline static std::atomic<std::uint64_t> m_bipedReused{ 0 };
+		inline static std::atomic<std::uint64_t> m_scbLookups{ 0 };
+		inline static std::atomic<std::uint64_t> m_scbLegacyTime{ 0 };
+		inline static std::atomic<std::uint64_t> m_scbSingleTime{ 0 };
+#endif
+
 		void Patch_SCB_Attach();
 		void Patch_SCB_Detach();
 		void Patch_SCB_Get();
@@ -99,6 +169,7 @@ namespace SDS
 		} m_dispatchers;
 
 		stl::smart_ptr<Controller> m_controller;
+		ScabbardLayoutCache        m_scbLayouts;
 
 		inline static auto m_scbAttach_a               = IAL::Address<std::uintptr_t>(15569, 15746, 0x3A3, 0x3BA);
 		inline static auto m_scbGet_a                  = IAL::Address<std::uintptr_t>(15569, 15746, 0x383, 0x396);
@@ -2,6 +2,7 @@
 
 #include "EquipManager.h"
 
+#include "Util/AllocCounter.h"
 #include "Util/Common.h"
 
 #include <ext/GameCommon.h>
@@ -10,42 +11,54 @@ namespace SDS
 {
 	using namespace Util::Common;
 
-	bool EquipExtensions::CheckDualWield(Actor* a_actor)
+	bool EquipExtensions::CheckDualWield(Actor* a_actor) const
 	{
-		auto race = a_actor->GetRace();
-
-		if (!race)
 		{
-			return false;
+			IScopedLock lock(m_dualWieldLock);
+
+			auto it = m_dualWield.find(a_actor->formID);
+			if (it != m_dualWield.end())
+			{
+				return it->second;
+			}
 		}
 
-		if (!race->data.raceFlags.test(TESRace::Flag::kCanDualWield))
+		const auto race = a_actor->GetRace();
+		if (!race)
 		{
 			return false;
 		}
 
+		const TESCombatStyle* cs = nullptr;
+
 		if (auto extraCombatStyle = a_actor->extraData.Get<ExtraCombatStyle>())
 		{
-			if (auto cs = extraCombatStyle->combatStyle)
-			{
-				return cs->csflags.test(TESCombatStyle::FLAG::kAllowDualWielding);
-			}
+			cs = extraCombatStyle->combatStyle;
 		}
 
-		if (auto npc = a_actor->GetActorBase())
+		if (!cs)
 		{
-			if (auto cs = npc->combatStyle)
+			if (auto npc = a_actor->GetActorBase())
 			{
-				return cs->csflags.test(TESCombatStyle::FLAG::kAllowDualWielding);
+				cs = npc->combatStyle;
 			}
 		}
 
-		return false;
+		const bool result =
+			race->data.raceFlags.test(TESRace::Flag::kCanDualWield) &&
+			cs &&
+			cs->csflags.test(TESCombatStyle::FLAG::kAllowDualWielding);
+
+		IScopedLock lock(m_dualWieldLock);
+
+		m_dualWield.insert_or_assign(a_actor->formID, result);
+
+		return result;
 	}
 
-	bool EquipExtensions::ActorQualifiesForEquip(Actor* a_actor)
+	bool EquipExtensions::ActorQualifiesForEquip(Actor* a_actor) const
 	{
-		return a_actor != *g_thePlayer && CheckDualWield(a_actor) && !a_actor->IsDead();
+		return a_actor != *g_thePlayer && !a_actor->IsDead() && CheckDualWield(a_actor);
 	}
 
 	EquipCandidateCollector::EquipCandidateCollector(
@@ -98,6 +111,70 @@ namespace SDS
 		m_results.try_emplace(weapon, 0).first->second += a_count;
 	}
 
+	void EquipCandidateIndex::Build(
+		Actor*                       a_actor,
+		ExtraContainerChanges::Data* a_containerData,
+		const WeaponScoreTable&      a_scores)
+	{
+		EquipCandidateCollector collector(nullptr);
+
+		if (auto npc = a_actor->GetActorBase())
+		{
+			npc->Visit(collector);
+		}
+
+		if (a_containerData->objList)
+		{
+			for (auto& e : *a_containerData->objList)
+			{
+				if (e)
+				{
+					collector.Accept(e);
+				}
+			}
+		}
+
+		m_counts.clear();
+		m_ordered.clear();
+
+		for (const auto& e : collector.m_results)
+		{
+			auto& entry = m_counts.try_emplace(e.first).first->second;
+			entry.count = e.second;
+
+			if (e.second > 0)
+			{
+				entry.score = a_scores.Get(e.first);
+				m_ordered.emplace(entry.score, e.first);
+			}
+		}
+	}
+
+	void EquipCandidateIndex::Apply(
+		TESObjectWEAP*          a_weapon,
+		std::int32_t            a_delta,
+		const WeaponScoreTable& a_scores)
+	{
+		auto& entry = m_counts.try_emplace(a_weapon).first->second;
+
+		const bool had = entry.count > 0;
+		entry.count += a_delta;
+		const bool has = entry.count > 0;
+
+		if (had != has)
+		{
+			if (has)
+			{
+				entry.score = a_scores.Get(a_weapon);
+				m_ordered.emplace(entry.score, a_weapon);
+			}
+			else
+			{
+				m_ordered.erase(std::make_pair(entry.score, a_weapon));
+			}
+		}
+	}
+
 	enum class EquipItemResult
 	{
 		kEquipped,
@@ -106,6 +183,77 @@ namespace SDS
 		kNotEnoughItems
 	};
 
+	struct EquipEntryInfo
+	{
+		std::int32_t   count{ 0 };
+		BaseExtraList* wornRight{ nullptr };
+		BaseExtraList* wornLeft{ nullptr };
+		BaseExtraList* firstExtraList{ nullptr };
+	};
+
+	struct BaseCountVisitor
+	{
+		const TESForm* item;
+		std::int32_t   count{ 0 };
+		bool           found{ false };
+
+		bool Accept(TESContainer::Entry* a_entry)
+		{
+			if (a_entry && a_entry->form == item)
+			{
+				count += a_entry->count;
+				found = true;
+			}
+
+			return true;
+		}
+	};
+
+	// read-only equivalent of what CreateEquipEntryData gives us, without allocating an InventoryEntryData
+	static bool QueryEquipEntry(
+		Actor*                       a_actor,
+		ExtraContainerChanges::Data* a_containerData,
+		TESForm*                     a_item,
+		EquipEntryInfo&              a_out)
+	{
+		BaseCountVisitor visitor{ a_item };
+
+		if (auto npc = a_actor->GetActorBase())
+		{
+			npc->Visit(visitor);
+		}
+
+		bool found = visitor.found;
+
+		a_out.count = visitor.count;
+
+		if (a_containerData->objList)
+		{
+			for (auto& e : *a_containerData->objList)
+			{
+				if (!e || e->type != a_item)
+				{
+					continue;
+				}
+
+				found = true;
+
+				a_out.count += e->countDelta;
+
+				e->GetExtraWornBaseLists(&a_out.wornRight, &a_out.wornLeft);
+
+				if (e->extraLists && !e->extraLists->empty())
+				{
+					a_out.firstExtraList = e->extraLists->front();
+				}
+
+				break;
+			}
+		}
+
+		return found;
+	}
+
 	// modified EquipItemEx (SKSE)
 	static EquipItemResult EquipItem(
 		EquipManager*                a_equipManager,
@@ -119,13 +267,13 @@ namespace SDS
 			return EquipItemResult::kFailed;
 		}
 
-		auto entryData = a_containerData->CreateEquipEntryData(a_item);
-		if (!entryData)
+		EquipEntryInfo info;
+		if (!QueryEquipEntry(a_actor, a_containerData, a_item, info))
 		{
 			return EquipItemResult::kFailed;
 		}
 
-		auto itemCount = entryData->countDelta;
+		auto itemCount = info.count;
 
 		bool isTargetSlotInUse = false;
 
@@ -137,7 +285,8 @@ namespace SDS
 
 		if (hasItemMinCount)
 		{
-			entryData->GetExtraWornBaseLists(&rightEquipList, &leftEquipList);
+			rightEquipList = info.wornRight;
+			leftEquipList  = info.wornLeft;
 
 			if (leftEquipList && rightEquipList)
 			{
@@ -154,15 +303,10 @@ namespace SDS
 			else
 			{
 				isTargetSlotInUse = false;
-				if (entryData->extraLists && !entryData->extraLists->empty())
-				{
-					enchantList = entryData->extraLists->front();
-				}
+				enchantList       = info.firstExtraList;
 			}
 		}
 
-		delete entryData;
-
 		if (isTargetSlotInUse)
 		{
 			return EquipItemResult::kSlotInUse;
@@ -185,11 +329,109 @@ namespace SDS
 
 	void EquipExtensions::QueueEvaluateEquip(TESObjectREFR* a_actor) const
 	{
-		ITaskPool::QueueLoadedActorTask(
-			a_actor,
-			[this](Actor* a_actor, Game::ActorHandle) {
-				EvaluateEquip(a_actor);
-			});
+		{
+			IScopedLock lock(m_equipPendingLock);
+
+			m_equipRequests++;
+
+			if (!m_equipPending.emplace(a_actor->formID).second)
+			{
+				m_equipSkipped++;
+				return;
+			}
+
+			if (m_equipPassScheduled)
+			{
+				return;
+			}
+
+			m_equipPassScheduled = true;
+			m_equipDue           = m_equipLastPass + m_equipInterval;
+		}
+
+		ScheduleEquipPass();
+	}
+
+	void EquipExtensions::ScheduleEquipPass() const
+	{
+		ITaskPool::AddTask([this] {
+			ProcessPendingEquip();
+		});
+	}
+
+	void EquipExtensions::ProcessPendingEquip() const
+	{
+		const auto now = clock_type::now();
+
+		stl::vector<Actor*> actors;
+		bool                reschedule;
+
+		{
+			IScopedLock lock(m_equipPendingLock);
+
+			// not due yet, check again next frame
+			if (now < m_equipDue)
+			{
+				reschedule = true;
+			}
+			else
+			{
+				m_equipLastPass = now;
+				m_equipPasses++;
+
+				actors.reserve(m_equipPending.size());
+
+				// whatever is left over becomes due when the first cooldown runs out
+				auto nextDue = clock_type::time_point::max();
+
+				for (auto it = m_equipPending.begin(); it != m_equipPending.end();)
+				{
+					auto r = m_equipLastEval.try_emplace(*it, now);
+					if (!r.second)
+					{
+						// evaluated recently, leave it for a later pass
+						if (now - r.first->second < m_equipCooldown)
+						{
+							nextDue = std::min(nextDue, r.first->second + m_equipCooldown);
+
+							m_equipDeferred++;
+							++it;
+							continue;
+						}
+
+						r.first->second = now;
+					}
+
+					const auto actor = it->As<Actor>();
+					if (IsREFRValid(actor))
+					{
+						actors.emplace_back(actor);
+					}
+
+					it = m_equipPending.erase(it);
+				}
+
+				m_equipEvaluations += actors.size();
+
+				reschedule = !m_equipPending.empty();
+				m_equipDue = std::max(nextDue, now + m_equipInterval);
+			}
+
+			m_equipPassScheduled = reschedule;
+		}
+
+		if (reschedule)
+		{
+			ScheduleEquipPass();
+		}
+
+		for (auto& e : actors)
+		{
+			if (ActorQualifiesForEquip(e))
+			{
+				EvaluateEquip(e);
+			}
+		}
 	}
 
 	void EquipExtensions::EvaluateEquip(Actor* a_actor) const
@@ -254,62 +496,148 @@ namespace SDS
 			return;
 		}
 
-		EquipCandidateCollector collector(weaponRight);
+		IScopedLock lock(m_equipIndexLock);
 
-		if (auto npc = a_actor->GetActorBase())
+		auto r = m_equipIndex.try_emplace(a_actor->formID);
+		if (r.second)
 		{
-			npc->Visit(collector);
+			r.first->second.Build(a_actor, containerData, m_weaponScores);
 		}
 
-		if (containerData->objList)
+#ifdef _SDS_DEBUG
+		Util::AllocCounter::Scope allocScope(__FUNCTION__);
+#endif
+
+		auto tryEquip = [&](TESObjectWEAP* a_weapon) {
+			auto res = EquipItem(equipManager, containerData, a_actor, a_weapon);
+			return res == EquipItemResult::kSlotInUse ||
+			       res == EquipItemResult::kEquipped;
+		};
+
+		const auto& ordered = r.first->second.GetOrdered();
+
+		auto it = ordered.begin();
+
+		if (m_weaponScores.HasSkillTerm())
 		{
-			for (auto& e : *containerData->objList)
+			// re-rank the best few by the actor's skill in each weapon class
+			constexpr std::size_t TOP_K = 8;
+
+			std::pair<float, TESObjectWEAP*> top[TOP_K];
+			std::size_t                      n = 0;
+
+			for (; it != ordered.end() && n < TOP_K; ++it)
 			{
-				if (e)
+				if (it->second != weaponRight)
 				{
-					collector.Accept(e);
+					top[n++] = {
+						it->first + m_weaponScores.GetSkillTerm(a_actor, it->second),
+						it->second
+					};
 				}
 			}
-		}
 
-		if (collector.m_results.empty())
-		{
-			return;
-		}
+			std::sort(top, top + n, std::greater<>());
 
-		stl::vector<std::pair<std::uint32_t, TESObjectWEAP*>> sortedWeapons;
-		sortedWeapons.reserve(collector.m_results.size());
+			for (std::size_t i = 0; i < n; i++)
+			{
+				if (tryEquip(top[i].second))
+				{
+					return;
+				}
+			}
+		}
 
-		for (const auto& e : collector.m_results)
+		for (; it != ordered.end(); ++it)
 		{
-			if (e.second <= 0)
+			if (it->second == weaponRight)
 			{
 				continue;
 			}
 
-			auto damage = static_cast<std::uint32_t>(e.first->attackDamage);
+			if (tryEquip(it->second))
+			{
+				return;
+			}
+		}
+	}
 
-			auto it = std::lower_bound(
-				sortedWeapons.cbegin(),
-				sortedWeapons.cend(),
-				damage,
-				[](auto& a_data, auto a_value) {
-					return a_data.first > a_value;
-				});
+	void EquipExtensions::ApplyContainerDelta(
+		Game::FormID   a_actor,
+		TESObjectWEAP* a_weapon,
+		std::int32_t   a_delta) const
+	{
+		IScopedLock lock(m_equipIndexLock);
 
-			sortedWeapons.emplace(it, damage, e.first);
+		// only maintained once built by an evaluation
+		auto it = m_equipIndex.find(a_actor);
+		if (it != m_equipIndex.end())
+		{
+			it->second.Apply(a_weapon, a_delta, m_weaponScores);
 		}
+	}
 
-		for (const auto& e : sortedWeapons)
+	void EquipExtensions::DropEquipIndex(Game::FormID a_actor) const
+	{
 		{
-			auto r = EquipItem(equipManager, containerData, a_actor, e.second);
-			switch (r)
-			{
-			case EquipItemResult::kSlotInUse:
-			case EquipItemResult::kEquipped:
-				return;
-			}
+			IScopedLock lock(m_equipIndexLock);
+
+			m_equipIndex.erase(a_actor);
 		}
+
+		IScopedLock lock(m_equipPendingLock);
+
+		m_equipPending.erase(a_actor);
+		m_equipLastEval.erase(a_actor);
+	}
+
+	void EquipExtensions::ClearEquipIndex() const
+	{
+		{
+			IScopedLock lock(m_equipIndexLock);
+
+			m_equipIndex.clear();
+		}
+
+		IScopedLock lock(m_equipPendingLock);
+
+		m_equipPending.clear();
+		m_equipLastEval.clear();
+	}
+
+	void EquipExtensions::InvalidateDualWield(Game::FormID a_actor) const
+	{
+		IScopedLock lock(m_dualWieldLock);
+
+		m_dualWield.erase(a_actor);
+	}
+
+	void EquipExtensions::ClearDualWieldCache() const
+	{
+		IScopedLock lock(m_dualWieldLock);
+
+		m_dualWield.clear();
+	}
+
+	std::size_t EquipExtensions::GetDualWieldCacheSize() const
+	{
+		IScopedLock lock(m_dualWieldLock);
+
+		return m_dualWield.size();
+	}
+
+	auto EquipExtensions::GetEquipStats() const
+		-> EquipStats
+	{
+		IScopedLock lock(m_equipPendingLock);
+
+		return {
+			m_equipRequests,
+			m_equipSkipped,
+			m_equipDeferred,
+			m_equipEvaluations,
+			m_equipPasses
+		};
 	}
 
 	auto EquipExtensions::ReceiveEvent(
@@ -319,13 +647,16 @@ namespace SDS
 	{
 		if (a_evn)
 		{
-			if (auto actor = a_evn->newContainer.As<Actor>())
+			if (auto weapon = a_evn->baseObj.As<TESObjectWEAP>())
 			{
-				if (ActorQualifiesForEquip(actor))
+				if (CanEquipEitherHand(weapon))
 				{
-					if (auto weapon = a_evn->baseObj.As<TESObjectWEAP>())
+					ApplyContainerDelta(a_evn->oldContainer, weapon, -a_evn->itemCount);
+					ApplyContainerDelta(a_evn->newContainer, weapon, a_evn->itemCount);
+
+					if (auto actor = a_evn->newContainer.As<Actor>())
 					{
-						if (CanEquipEitherHand(weapon))
+						if (ActorQualifiesForEquip(actor))
 						{
 							QueueEvaluateEquip(actor);
 						}
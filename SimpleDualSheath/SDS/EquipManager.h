@@ -1,5 +1,7 @@
 #pragma once
 
+#include "WeaponScoreTable.h"
+
 namespace SDS
 {
 	struct EquipCandidateCollector
@@ -19,20 +21,106 @@ namespace SDS
 		void Process(TESForm* a_item, T a_count);
 	};
 
+	// eligible one-handed weapons in an actor's inventory, ordered by score and kept up to date from container change deltas
+	class EquipCandidateIndex
+	{
+		struct Entry
+		{
+			std::int32_t count{ 0 };
+			float        score{ 0.0f };  // what it was inserted with, scores may be rebuilt while we hold it
+		};
+
+	public:
+		using ordered_type = std::set<std::pair<float, TESObjectWEAP*>, std::greater<>>;
+
+		EquipCandidateIndex() = default;
+
+		void Build(
+			Actor*                       a_actor,
+			ExtraContainerChanges::Data* a_containerData,
+			const WeaponScoreTable&      a_scores);
+
+		void Apply(
+			TESObjectWEAP*          a_weapon,
+			std::int32_t            a_delta,
+			const WeaponScoreTable& a_scores);
+
+		[[nodiscard]] inline constexpr const auto& GetOrdered() const noexcept
+		{
+			return m_ordered;
+		}
+
+	private:
+		stl::flat_map<TESObjectWEAP*, Entry> m_counts;
+		ordered_type                         m_ordered;
+	};
+
 	class EquipExtensions :
 		public BSTEventSink<TESContainerChangedEvent>
 	{
+		using clock_type = std::chrono::steady_clock;
+
 	public:
+		struct EquipStats
+		{
+			std::uint64_t requests;
+			std::uint64_t skipped;
+			std::uint64_t deferred;
+			std::uint64_t evaluations;
+			std::uint64_t passes;
+		};
+
 	protected:
-		static bool CheckDualWield(Actor* a_actor);
-		static bool ActorQualifiesForEquip(Actor* a_actor);
+		bool CheckDualWield(Actor* a_actor) const;
+		bool ActorQualifiesForEquip(Actor* a_actor) const;
 
+		// batched, see ProcessPendingEquip
 		void QueueEvaluateEquip(TESObjectREFR* a_actor) const;
 
 		void EvaluateEquip(Actor* a_actor) const;
 
+		void DropEquipIndex(Game::FormID a_actor) const;
+		void ClearEquipIndex() const;
+		// race switch, or the reference (and with it ExtraCombatStyle) was loaded again
+		void InvalidateDualWield(Game::FormID a_actor) const;
+		void ClearDualWieldCache() const;
+
+		[[nodiscard]] std::size_t GetDualWieldCacheSize() const;
+		[[nodiscard]] EquipStats  GetEquipStats() const;
+
+		WeaponScoreTable m_weaponScores;
+
+		std::chrono::milliseconds m_equipInterval{ 250 };
+		std::chrono::milliseconds m_equipCooldown{ 1000 };
+
 		virtual EventResult ReceiveEvent(
 			const TESContainerChangedEvent*           a_evn,
 			BSTEventSource<TESContainerChangedEvent>* a_dispatcher) override;
+
+	private:
+		void ProcessPendingEquip() const;
+		// next frame, the pass returns early and queues itself again until m_equipDue has passed
+		void ScheduleEquipPass() const;
+
+		void ApplyContainerDelta(Game::FormID a_actor, TESObjectWEAP* a_weapon, std::int32_t a_delta) const;
+
+		mutable WCriticalSection                                      m_equipIndexLock;
+		mutable std::unordered_map<Game::FormID, EquipCandidateIndex> m_equipIndex;
+
+		mutable WCriticalSection                       m_dualWieldLock;
+		mutable std::unordered_map<Game::FormID, bool> m_dualWield;
+
+		mutable WCriticalSection                                          m_equipPendingLock;
+		mutable std::unordered_set<Game::FormID>                          m_equipPending;
+		mutable std::unordered_map<Game::FormID, clock_type::time_point> m_equipLastEval;
+		mutable clock_type::time_point                                    m_equipLastPass;
+		mutable clock_type::time_point                                    m_equipDue;
+		mutable bool                                                      m_equipPassScheduled{ false };
+
+		mutable std::uint64_t m_equipRequests{ 0 };
+		mutable std::uint64_t m_equipSkipped{ 0 };
+		mutable std::uint64_t m_equipDeferred{ 0 };
+		mutable std::uint64_t m_equipEvaluations{ 0 };
+		mutable std::uint64_t m_equipPasses{ 0 };
 	};
 }
\ No newline at end of file
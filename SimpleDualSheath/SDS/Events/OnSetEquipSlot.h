@@ -6,7 +6,7 @@ namespace SDS
 	{
 		struct OnSetEquipSlot
 		{
-			//TESObjectWEAP* weapon;
+			TESObjectWEAP* weapon;
 		};
 	}
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "Main.h"
 
 #include "Config.h"
+#include "ConfigWatcher.h"
 #include "Controller.h"
 #include "EngineExtensions.h"
 #include "PluginInterface.h"
@@ -13,6 +14,7 @@ namespace SDS
 {
 	static stl::smart_ptr<Controller>       s_controller;
 	static std::unique_ptr<PluginInterface> s_pluginInterface;
+	static std::unique_ptr<ConfigWatcher>   s_configWatcher;
 
 	static bool s_loaded = false;
 
@@ -46,6 +48,8 @@ namespace SDS
 			{
 				s_controller->InitializeData();
 
+				EngineExtensions::UpdateHookFilter(s_controller->GetSnapshot());
+
 				if (auto edl = ScriptEventSourceHolder::GetSingleton())
 				{
 					edl->AddEventSink<TESObjectLoadedEvent>(s_controller.get());
@@ -54,9 +58,14 @@ namespace SDS
 
 					auto& config = s_controller->GetConfig();
 
-					if (config.m_npcEquipLeft)
+					if (config.m_npcEquipLeft ||
+					    (config.m_shield.IsEnabled() && config.m_shieldHandWorkaround))
 					{
 						edl->AddEventSink<TESEquipEvent>(s_controller.get());
+					}
+
+					if (config.m_npcEquipLeft)
+					{
 						edl->AddEventSink<TESContainerChangedEvent>(s_controller.get());
 					}
 				}
@@ -64,9 +73,68 @@ namespace SDS
 				{
 					gLog.Error("Couldn't get event dispatcher list");
 				}
+
+				if (s_controller->GetConfig().m_watchConfigFile)
+				{
+					s_configWatcher = std::make_unique<ConfigWatcher>(
+						PLUGIN_INI_FILE_NOEXT ".ini",
+						[] {
+							s_controller->ReloadConfig();
+
+							EngineExtensions::UpdateHookFilter(s_controller->GetSnapshot());
+						});
+
+					if (!s_configWatcher->Start())
+					{
+						gLog.Error("Couldn't start config file watcher");
+						s_configWatcher.reset();
+					}
+				}
 			}
 			break;
+		case SKSEMessagingInterface::kMessage_PreLoadGame:
+			s_controller->ClearCaches();
+			break;
 		case SKSEMessagingInterface::kMessage_PostLoadGame:
+			s_controller->LogStats();
+
+			if (auto ee = EngineExtensions::GetSingleton())
+			{
+				const auto stats = ee->GetScabbardLayoutStats();
+
+				gLog.Debug(
+					"Scabbard layouts: %zu models, %llu hits, %llu misses, %llu mismatches",
+					stats.models,
+					stats.hits,
+					stats.misses,
+					stats.mismatches);
+			}
+
+#ifdef _SDS_DEBUG
+			{
+				// each lookup is a refcount increment/decrement pair on the ref, reuses are free
+				const auto stats = EngineExtensions::GetBipedContextStats();
+
+				gLog.Debug(
+					"Biped context: %llu lookups, %llu reused",
+					stats.lookups,
+					stats.reused);
+			}
+
+			{
+				const auto stats = EngineExtensions::GetScabbardLookupStats();
+
+				if (stats.calls)
+				{
+					gLog.Debug(
+						"Scabbard lookup: %llu calls, avg %llu ns (two searches) / %llu ns (single pass)",
+						stats.calls,
+						stats.legacyTime / stats.calls,
+						stats.singleTime / stats.calls);
+				}
+			}
+#endif
+
 			// skip first, evaluate on subsequent loads
 			if (s_loaded)
 			{
@@ -175,11 +243,11 @@ namespace SDS
 
 		auto mif = skse.GetInterface<SKSEMessagingInterface>();
 
-		/*auto nnupd_evd = mif->GetEventDispatcher<SKSENiNodeUpdateEvent>();
+		auto nnupd_evd = mif->GetEventDispatcher<SKSENiNodeUpdateEvent>();
 		if (!nnupd_evd)
 		{
 			gLog.Warning("Could not get NiNodeUpdateEvent dispatcher");
-		}*/
+		}
 
 		auto aed = mif->GetEventDispatcher<SKSEActionEvent>();
 		if (!aed)
@@ -207,7 +275,11 @@ namespace SDS
 
 		EngineExtensions::Initialize(controller);
 
-		//nnupd_evd->AddEventSink(controller.get());
+		if (nnupd_evd)
+		{
+			nnupd_evd->AddEventSink(controller.get());
+		}
+
 		aed->AddEventSink(controller.get());
 
 		s_controller = controller;
@@ -0,0 +1,147 @@
+#include "pch.h"
+
+#include "NodeCache.h"
+
+namespace SDS
+{
+	auto NodeCache::GetRootEntry(
+		Actor*        a_actor,
+		std::uint32_t a_rootIndex,
+		NiNode*       a_root)
+		-> RootEntry&
+	{
+		auto& entry = m_data.try_emplace(a_actor->formID).first->second.roots[a_rootIndex];
+
+		// skeleton was rebuilt, anything we have is stale
+		if (entry.root != a_root)
+		{
+			entry.root = a_root;
+			entry.nodes.clear();
+
+			for (auto& e : entry.objects)
+			{
+				e = nullptr;
+			}
+		}
+
+		return entry;
+	}
+
+	NiNode* NodeCache::GetNode(
+		Actor*               a_actor,
+		std::uint32_t        a_rootIndex,
+		NiNode*              a_root,
+		const BSFixedString& a_name)
+	{
+		IScopedLock lock(m_lock);
+
+		auto& entry = GetRootEntry(a_actor, a_rootIndex, a_root);
+
+		const auto key = a_name.__ptr();
+
+		auto it = entry.nodes.find(key);
+		if (it != entry.nodes.end())
+		{
+			if (!it->second)
+			{
+				m_negativeHits++;
+				return nullptr;
+			}
+
+			// detached by someone else since we cached it, or part of a subtree that was rebuilt
+			if (Util::Node::IsChildOf(it->second, a_root))
+			{
+				m_hits++;
+				return it->second;
+			}
+
+			entry.nodes.erase(it);
+		}
+
+		m_misses++;
+
+		bool missing;
+
+		const auto result = m_paths.GetNode(a_actor, a_rootIndex, a_root, a_name, missing);
+		if (result || missing)
+		{
+			entry.nodes.emplace(key, result);
+		}
+
+		return result;
+	}
+
+	NiAVObject* NodeCache::GetAttachedObject(
+		Actor*               a_actor,
+		std::uint32_t        a_rootIndex,
+		NiNode*              a_root,
+		ObjectSlot           a_slot,
+		const BSFixedString& a_name,
+		NiNode*              a_parent1,
+		NiNode*              a_parent2,
+		bool                 a_anyParent)
+	{
+		IScopedLock lock(m_lock);
+
+		auto& object = GetRootEntry(a_actor, a_rootIndex, a_root).objects[stl::underlying(a_slot)];
+		if (object)
+		{
+			const auto parent = object->m_parent;
+
+			if ((parent == a_parent1 || parent == a_parent2 || (a_anyParent && parent)) &&
+			    object->m_name == a_name)
+			{
+				m_objectHits++;
+				return object;
+			}
+
+			// detached, moved by something else or a different item is equipped now
+			object = nullptr;
+		}
+
+		m_objectMisses++;
+
+		return nullptr;
+	}
+
+	void NodeCache::SetAttachedObject(
+		Actor*        a_actor,
+		std::uint32_t a_rootIndex,
+		NiNode*       a_root,
+		ObjectSlot    a_slot,
+		NiAVObject*   a_object)
+	{
+		IScopedLock lock(m_lock);
+
+		GetRootEntry(a_actor, a_rootIndex, a_root).objects[stl::underlying(a_slot)] = a_object;
+	}
+
+	void NodeCache::Invalidate(Game::FormID a_actor)
+	{
+		IScopedLock lock(m_lock);
+
+		m_data.erase(a_actor);
+	}
+
+	void NodeCache::Clear()
+	{
+		IScopedLock lock(m_lock);
+
+		m_data.clear();
+	}
+
+	auto NodeCache::GetStats() const
+		-> Stats
+	{
+		IScopedLock lock(m_lock);
+
+		return {
+			m_hits,
+			m_misses,
+			m_negativeHits,
+			m_objectHits,
+			m_objectMisses,
+			m_data.size()
+		};
+	}
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "NodePathTable.h"
+
+namespace SDS
+{
+	class NodeCache
+	{
+	public:
+		enum class ObjectSlot : std::uint32_t
+		{
+			kWeaponLeft  = 0,
+			kWeaponRight = 1,
+
+			kMax
+		};
+
+	private:
+		struct RootEntry
+		{
+			NiPointer<NiNode> root;
+
+			// null means a complete search of this actor's skeleton didn't find it
+			stl::flat_map<const char*, NiPointer<NiNode>> nodes;
+
+			NiPointer<NiAVObject>                         objects[stl::underlying(ObjectSlot::kMax)];
+		};
+
+		struct Entry
+		{
+			RootEntry roots[2];
+		};
+
+	public:
+		struct Stats
+		{
+			std::uint64_t hits;
+			std::uint64_t misses;
+			std::uint64_t negativeHits;
+			std::uint64_t objectHits;
+			std::uint64_t objectMisses;
+			std::size_t   actors;
+		};
+
+		NodeCache() = default;
+
+		NodeCache(const NodeCache&)            = delete;
+		NodeCache& operator=(const NodeCache&) = delete;
+
+		[[nodiscard]] NiNode* GetNode(
+			Actor*               a_actor,
+			std::uint32_t        a_rootIndex,
+			NiNode*              a_root,
+			const BSFixedString& a_name);
+
+		// last object we attached for a slot, null if it's gone or was moved elsewhere (unless a_anyParent is set,
+		// used when the sheath node itself changed)
+		[[nodiscard]] NiAVObject* GetAttachedObject(
+			Actor*               a_actor,
+			std::uint32_t        a_rootIndex,
+			NiNode*              a_root,
+			ObjectSlot           a_slot,
+			const BSFixedString& a_name,
+			NiNode*              a_parent1,
+			NiNode*              a_parent2,
+			bool                 a_anyParent = false);
+
+		void SetAttachedObject(
+			Actor*        a_actor,
+			std::uint32_t a_rootIndex,
+			NiNode*       a_root,
+			ObjectSlot    a_slot,
+			NiAVObject*   a_object);
+
+		void Invalidate(Game::FormID a_actor);
+		void Clear();
+
+		[[nodiscard]] Stats GetStats() const;
+
+		[[nodiscard]] inline constexpr auto& GetPathTable() noexcept
+		{
+			return m_paths;
+		}
+
+		[[nodiscard]] inline constexpr auto& GetPathTable() const noexcept
+		{
+			return m_paths;
+		}
+
+	private:
+		RootEntry& GetRootEntry(
+			Actor*        a_actor,
+			std::uint32_t a_rootIndex,
+			NiNode*       a_root);
+
+		mutable WCriticalSection m_lock;
+
+		std::unordered_map<Game::FormID, Entry> m_data;
+		NodePathTable                           m_paths;
+
+		std::uint64_t m_hits{ 0 };
+		std::uint64_t m_misses{ 0 };
+		std::uint64_t m_negativeHits{ 0 };
+		std::uint64_t m_objectHits{ 0 };
+		std::uint64_t m_objectMisses{ 0 };
+	};
+}
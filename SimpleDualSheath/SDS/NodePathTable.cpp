@@ -0,0 +1,97 @@
+#include "pch.h"
+
+#include "NodePathTable.h"
+
+#include <ext/Node.h>
+
+namespace SDS
+{
+	using namespace Util::Node;
+
+	auto NodePathTable::MakeKey(
+		Actor*        a_actor,
+		std::uint32_t a_rootIndex)
+		-> key_type
+	{
+		const auto race = a_actor->GetRace();
+		if (!race)
+		{
+			return 0;
+		}
+
+		const auto npc = a_actor->GetActorBase();
+		const auto sex = npc ? npc->GetSex() : 0;
+
+		// forms are 8 byte aligned, low bits hold sex and 1p/3p
+		return reinterpret_cast<key_type>(race) |
+		       (static_cast<key_type>(sex & 1) << 1) |
+		       static_cast<key_type>(a_rootIndex & 1);
+	}
+
+	NiNode* NodePathTable::GetNode(
+		Actor*               a_actor,
+		std::uint32_t        a_rootIndex,
+		NiNode*              a_root,
+		const BSFixedString& a_name,
+		bool&                a_missing)
+	{
+		a_missing = false;
+
+		const auto key = MakeKey(a_actor, a_rootIndex);
+
+		IScopedLock lock(m_lock);
+
+		if (key)
+		{
+			auto it = m_data.find(key);
+			if (it != m_data.end())
+			{
+				auto jt = it->second.find(a_name.__ptr());
+				if (jt != it->second.end())
+				{
+					if (auto result = ResolveNodePath(a_root, jt->second, a_name))
+					{
+						m_hits++;
+						return result;
+					}
+
+					// this actor's skeleton differs from the one we recorded, search it
+					m_mismatches++;
+				}
+			}
+		}
+
+		NodePath path;
+
+		switch (FindNodePath(a_root, a_name, path))
+		{
+		case PathSearchResult::kFound:
+			if (key)
+			{
+				m_recorded++;
+				m_data.try_emplace(key).first->second.insert_or_assign(a_name.__ptr(), path);
+			}
+
+			return ResolveNodePath(a_root, path, a_name);
+		case PathSearchResult::kNotFound:
+			a_missing = true;
+			return nullptr;
+		default:
+			// too deep to tell, fall back to the game's search and remember nothing
+			return ::Util::Node::GetNodeByName(a_root, a_name);
+		}
+	}
+
+	auto NodePathTable::GetStats() const
+		-> Stats
+	{
+		IScopedLock lock(m_lock);
+
+		return {
+			m_hits,
+			m_mismatches,
+			m_recorded,
+			m_data.size()
+		};
+	}
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Util/Node.h"
+
+namespace SDS
+{
+	// child index paths from the NPC root, recorded once per skeleton (race, sex, 1p/3p)
+	// and shared by every actor using it. only paths that were found are kept, every use
+	// verifies them, so an actor with a different skeleton only costs a search. what
+	// isn't there is up to the caller to remember per actor.
+	class NodePathTable
+	{
+		using key_type = std::uintptr_t;
+
+	public:
+		struct Stats
+		{
+			std::uint64_t hits;
+			std::uint64_t mismatches;
+			std::uint64_t recorded;
+			std::size_t   skeletons;
+		};
+
+		NodePathTable() = default;
+
+		NodePathTable(const NodePathTable&)            = delete;
+		NodePathTable& operator=(const NodePathTable&) = delete;
+
+		// a_missing is set if a complete search of a_root found nothing
+		[[nodiscard]] NiNode* GetNode(
+			Actor*               a_actor,
+			std::uint32_t        a_rootIndex,
+			NiNode*              a_root,
+			const BSFixedString& a_name,
+			bool&                a_missing);
+
+		[[nodiscard]] Stats GetStats() const;
+
+	private:
+		[[nodiscard]] static key_type MakeKey(Actor* a_actor, std::uint32_t a_rootIndex);
+
+		mutable WCriticalSection m_lock;
+
+		std::unordered_map<key_type, stl::flat_map<const char*, Util::Node::NodePath>> m_data;
+
+		std::uint64_t m_hits{ 0 };
+		std::uint64_t m_mismatches{ 0 };
+		std::uint64_t m_recorded{ 0 };
+	};
+}
@@ -0,0 +1,184 @@
+#include "pch.h"
+
+#include "ScabbardLayoutCache.h"
+
+namespace SDS
+{
+	using namespace Util::Node;
+
+	bool ScabbardLayoutCache::Remove(
+		NiNode*              a_root,
+		Slot                 a_slot,
+		const BSFixedString& a_name)
+	{
+		const auto key = a_root->m_name.__ptr();
+
+		IScopedLock lock(m_lock);
+
+		if (key)
+		{
+			auto it = m_data.find(key);
+			if (it != m_data.end())
+			{
+				const auto& layouts = it->second.slots[stl::underlying(a_slot)];
+
+				for (std::uint32_t i = 0; i < layouts.count; i++)
+				{
+					if (DetachAt(a_root, layouts.paths[i], a_name))
+					{
+						m_hits++;
+						return true;
+					}
+				}
+
+				if (layouts.count)
+				{
+					// a model we haven't seen with the same root name, or it was edited
+					m_mismatches++;
+				}
+			}
+		}
+
+		m_misses++;
+
+		NodePath path;
+
+		// not cached, models without scabbards just take the search every time
+		if (!Find(a_root, a_name, path))
+		{
+			return false;
+		}
+
+		if (key)
+		{
+			auto& layouts = m_data.try_emplace(key).first->second.slots[stl::underlying(a_slot)];
+
+			// none of the others matched so this one is new, once full the rest are searched
+			if (layouts.count < MAX_LAYOUTS)
+			{
+				layouts.paths[layouts.count++] = path;
+			}
+		}
+
+		return DetachAt(a_root, path, a_name);
+	}
+
+	bool ScabbardLayoutCache::DetachAt(
+		NiNode*              a_root,
+		const NodePath&      a_path,
+		const BSFixedString& a_name)
+	{
+		if (!a_path.depth)
+		{
+			return false;
+		}
+
+		auto node = a_root;
+
+		// everything before the last index is a FadeNode wrapper
+		for (std::uint32_t i = 0; i < a_path.depth - 1; i++)
+		{
+			const auto index = a_path.indices[i];
+
+			if (index >= node->m_children.freeidx())
+			{
+				return false;
+			}
+
+			const auto& e = node->m_children[index];
+			if (!e)
+			{
+				return false;
+			}
+
+			node = e->AsNode();
+			if (!node)
+			{
+				return false;
+			}
+		}
+
+		const auto index = a_path.indices[a_path.depth - 1];
+
+		if (index >= node->m_children.freeidx())
+		{
+			return false;
+		}
+
+		const auto& e = node->m_children[index];
+
+		// pooled strings, pointer compare is case insensitive
+		if (!e || !(e->m_name == a_name))
+		{
+			return false;
+		}
+
+		node->DetachChildAt2(index);
+
+		return true;
+	}
+
+	bool ScabbardLayoutCache::Find(
+		NiNode*              a_node,
+		const BSFixedString& a_name,
+		NodePath&            a_out)
+	{
+		a_out.depth = 0;
+
+		auto node = a_node;
+
+		while (a_out.depth < MAX_PATH_DEPTH)
+		{
+			NiNode* next = nullptr;
+
+			for (std::uint16_t i = 0; i < node->m_children.freeidx(); i++)
+			{
+				const auto& e = node->m_children[i];
+				if (!e)
+				{
+					continue;
+				}
+
+				if (e->m_name == a_name)
+				{
+					a_out.indices[a_out.depth++] = i;
+					return true;
+				}
+
+				// the game only descends into the first FadeNode it runs into
+				const auto p = e->m_name.__ptr();
+				if (p && ::_strnicmp(p, "FadeNode ", 9) == 0)
+				{
+					if ((next = e->AsNode()))
+					{
+						a_out.indices[a_out.depth++] = i;
+					}
+
+					break;
+				}
+			}
+
+			if (!next)
+			{
+				break;
+			}
+
+			node = next;
+		}
+
+		return false;
+	}
+
+	auto ScabbardLayoutCache::GetStats() const
+		-> Stats
+	{
+		IScopedLock lock(m_lock);
+
+		return {
+			m_hits,
+			m_misses,
+			m_mismatches,
+			m_data.size()
+		};
+	}
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Util/Node.h"
+
+namespace SDS
+{
+	// where Scb/ScbLeft sit in a weapon model (child indices through any FadeNode wrappers),
+	// keyed by the model's root name since that's all RemoveWeaponScabbard gets. models
+	// sharing a root name get a layout each (up to MAX_LAYOUTS), tried in the order they
+	// were seen, every one is verified against the live tree before detaching.
+	class ScabbardLayoutCache
+	{
+	public:
+		enum class Slot : std::uint32_t
+		{
+			kScb     = 0,
+			kScbLeft = 1,
+
+			kMax
+		};
+
+		struct Stats
+		{
+			std::uint64_t hits;
+			std::uint64_t misses;
+			std::uint64_t mismatches;
+			std::size_t   models;
+		};
+
+		ScabbardLayoutCache() = default;
+
+		ScabbardLayoutCache(const ScabbardLayoutCache&)            = delete;
+		ScabbardLayoutCache& operator=(const ScabbardLayoutCache&) = delete;
+
+		// detaches the first match, same rules as the game's search
+		bool Remove(
+			NiNode*              a_root,
+			Slot                 a_slot,
+			const BSFixedString& a_name);
+
+		[[nodiscard]] Stats GetStats() const;
+
+	private:
+		inline static constexpr std::uint32_t MAX_LAYOUTS = 4;
+
+		struct Layouts
+		{
+			std::uint32_t        count{ 0 };
+			Util::Node::NodePath paths[MAX_LAYOUTS];
+		};
+
+		struct Entry
+		{
+			Layouts slots[stl::underlying(Slot::kMax)];
+		};
+
+		static bool DetachAt(
+			NiNode*                     a_root,
+			const Util::Node::NodePath& a_path,
+			const BSFixedString&        a_name);
+
+		static bool Find(
+			NiNode*               a_node,
+			const BSFixedString&  a_name,
+			Util::Node::NodePath& a_out);
+
+		mutable WCriticalSection m_lock;
+
+		std::unordered_map<const char*, Entry> m_data;
+
+		std::uint64_t m_hits{ 0 };
+		std::uint64_t m_misses{ 0 };
+		std::uint64_t m_mismatches{ 0 };
+	};
+}
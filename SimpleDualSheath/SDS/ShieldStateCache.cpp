@@ -0,0 +1,147 @@
+#include "pch.h"
+
+#include "ShieldStateCache.h"
+
+namespace SDS
+{
+	bool ShieldStateCache::Get(
+		Game::FormID      a_actor,
+		stl::flag<State>& a_out) const
+	{
+		const auto key = MakeKey(a_actor);
+
+		auto index = GetIndex(a_actor);
+
+		for (std::size_t i = 0; i < MAX_PROBE; i++)
+		{
+			const auto v = m_data[index].load(std::memory_order_acquire);
+			if (!v)
+			{
+				break;
+			}
+
+			if ((v & 0xFFFFFFFF00000000ui64) == key)
+			{
+				if (!(v & VALID_BIT))
+				{
+					break;
+				}
+
+#ifdef _SDS_DEBUG
+				m_hits.fetch_add(1, std::memory_order_relaxed);
+#endif
+				a_out = stl::flag<State>{ static_cast<State>(v & 0xFF) };
+
+				return true;
+			}
+
+			index = (index + 1) & (TABLE_SIZE - 1);
+		}
+
+		m_misses.fetch_add(1, std::memory_order_relaxed);
+
+		return false;
+	}
+
+	void ShieldStateCache::Set(
+		Game::FormID     a_actor,
+		stl::flag<State> a_state)
+	{
+		const auto key = MakeKey(a_actor);
+
+		auto value = key | VALID_BIT;
+
+		for (const auto e : { State::kEnabled, State::kSwitch, State::kEquipped })
+		{
+			if (a_state.test(e))
+			{
+				value |= static_cast<std::uint64_t>(stl::underlying(e));
+			}
+		}
+
+		auto index = GetIndex(a_actor);
+
+		for (std::size_t i = 0; i < MAX_PROBE; i++)
+		{
+			auto& e = m_data[index];
+
+			auto v = e.load(std::memory_order_acquire);
+
+			if (!v)
+			{
+				if (e.compare_exchange_strong(v, value, std::memory_order_acq_rel))
+				{
+					return;
+				}
+
+				// someone else took it, may have been us on another thread
+			}
+
+			if ((v & 0xFFFFFFFF00000000ui64) == key)
+			{
+				e.store(value, std::memory_order_release);
+				return;
+			}
+
+			index = (index + 1) & (TABLE_SIZE - 1);
+		}
+
+		m_full.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void ShieldStateCache::Invalidate(Game::FormID a_actor)
+	{
+		const auto key = MakeKey(a_actor);
+
+		auto index = GetIndex(a_actor);
+
+		for (std::size_t i = 0; i < MAX_PROBE; i++)
+		{
+			auto& e = m_data[index];
+
+			const auto v = e.load(std::memory_order_acquire);
+			if (!v)
+			{
+				return;
+			}
+
+			if ((v & 0xFFFFFFFF00000000ui64) == key)
+			{
+				// keep the slot, it may be part of another actor's chain
+				e.store(key, std::memory_order_release);
+				return;
+			}
+
+			index = (index + 1) & (TABLE_SIZE - 1);
+		}
+	}
+
+	void ShieldStateCache::Clear()
+	{
+		for (auto& e : m_data)
+		{
+			e.store(0, std::memory_order_release);
+		}
+	}
+
+	auto ShieldStateCache::GetStats() const
+		-> Stats
+	{
+		std::size_t actors = 0;
+
+		for (auto& e : m_data)
+		{
+			if (e.load(std::memory_order_relaxed) & VALID_BIT)
+			{
+				actors++;
+			}
+		}
+
+		return {
+			m_hits.load(std::memory_order_relaxed),
+			m_misses.load(std::memory_order_relaxed),
+			m_full.load(std::memory_order_relaxed),
+			actors
+		};
+	}
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+namespace SDS
+{
+	// what the clenched hand hooks need to know about an actor, minus the drawn state
+	// which changes too often to be worth caching
+	class ShieldStateCache
+	{
+	public:
+		enum class State : std::uint8_t
+		{
+			kNone = 0,
+
+			kEnabled  = 1u << 0,  // shield on back enabled for this actor
+			kSwitch   = 1u << 1,  // player toggle
+			kEquipped = 1u << 2,  // shield in the left hand
+
+			kActive = kEnabled | kSwitch | kEquipped
+		};
+
+		struct Stats
+		{
+			std::uint64_t hits;  // debug builds only
+			std::uint64_t misses;
+			std::uint64_t full;
+			std::size_t   actors;
+		};
+
+		ShieldStateCache() = default;
+
+		ShieldStateCache(const ShieldStateCache&)            = delete;
+		ShieldStateCache& operator=(const ShieldStateCache&) = delete;
+
+		// no locks, called from animation graph update threads
+		[[nodiscard]] bool Get(Game::FormID a_actor, stl::flag<State>& a_out) const;
+		void               Set(Game::FormID a_actor, stl::flag<State> a_state);
+
+		void Invalidate(Game::FormID a_actor);
+		void Clear();
+
+		[[nodiscard]] Stats GetStats() const;
+
+	private:
+		// open addressing, one word per actor: form id << 32 | VALID_BIT | state.
+		// slots are never freed (invalidating only drops VALID_BIT) so probe chains stay intact,
+		// once it's full new actors just aren't cached until the next Clear.
+		inline static constexpr std::size_t   TABLE_SIZE = 4096;
+		inline static constexpr std::size_t   MAX_PROBE  = 16;
+		inline static constexpr std::uint64_t VALID_BIT  = 1ui64 << 8;
+
+		static_assert((TABLE_SIZE & (TABLE_SIZE - 1)) == 0);
+
+		[[nodiscard]] static inline std::size_t GetIndex(Game::FormID a_actor) noexcept
+		{
+			return static_cast<std::size_t>((static_cast<std::uint32_t>(a_actor) * 0x9E3779B1u) >> 20) & (TABLE_SIZE - 1);
+		}
+
+		[[nodiscard]] static inline std::uint64_t MakeKey(Game::FormID a_actor) noexcept
+		{
+			return static_cast<std::uint64_t>(static_cast<std::uint32_t>(a_actor)) << 32;
+		}
+
+		std::atomic<std::uint64_t> m_data[TABLE_SIZE]{};
+
+		mutable std::atomic<std::uint64_t> m_hits{ 0 };
+		mutable std::atomic<std::uint64_t> m_misses{ 0 };
+		std::atomic<std::uint64_t>         m_full{ 0 };
+	};
+
+	DEFINE_ENUM_CLASS_BITWISE(ShieldStateCache::State);
+}
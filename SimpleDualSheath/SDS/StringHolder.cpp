@@ -8,9 +8,11 @@ namespace SDS
 		m_shield(NINODE_SHIELD),
 		m_weapon(NINODE_WEAPON),
 		m_npcroot(NINODE_NPCROOT),
-		m_shieldSheathNode(NINODE_SHIELD_BACK),
 		m_iLeftHandType(iLeftHandType),
 		m_iLeftHandEquipped(iLeftHandEquipped),
+		m_weaponDraw(ANIM_WEAPON_DRAW),
+		m_weaponSheathe(ANIM_WEAPON_SHEATHE),
+		m_scb(NINODE_SCB),
 		m_scbLeft(NINODE_SCB_LEFT),
 		//m_weaponBack(NINODE_WEAPON_BACK),
 		m_weaponBackAxeMace(NINODE_WEAPON_BACK_AXE_MACE),
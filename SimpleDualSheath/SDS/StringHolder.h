@@ -32,12 +32,14 @@ namespace SDS
 		static inline constexpr auto iLeftHandType     = "iLeftHandType";
 		static inline constexpr auto iLeftHandEquipped = "iLeftHandEquipped";
 
+		static inline constexpr auto ANIM_WEAPON_DRAW    = "weaponDraw";
+		static inline constexpr auto ANIM_WEAPON_SHEATHE = "weaponSheathe";
+
+		static inline constexpr auto NINODE_SCB      = "Scb";
 		static inline constexpr auto NINODE_SCB_LEFT = "ScbLeft";
 
 		StringHolder();
 
-		BSFixedString m_shieldSheathNode;
-
 		BSFixedString m_shield;
 		BSFixedString m_weapon;
 
@@ -46,6 +48,10 @@ namespace SDS
 		BSFixedString m_iLeftHandType;
 		BSFixedString m_iLeftHandEquipped;
 
+		BSFixedString m_weaponDraw;
+		BSFixedString m_weaponSheathe;
+
+		BSFixedString m_scb;
 		BSFixedString m_scbLeft;
 
 		//BSFixedString m_weaponBack;
@@ -0,0 +1,64 @@
+#include "pch.h"
+
+#include "AllocCounter.h"
+
+#ifdef _SDS_DEBUG
+
+namespace SDS
+{
+	namespace Util
+	{
+		namespace AllocCounter
+		{
+			static thread_local std::uint64_t t_count = 0;
+
+			std::uint64_t Get() noexcept
+			{
+				return t_count;
+			}
+
+			void Increment() noexcept
+			{
+				t_count++;
+			}
+
+			Scope::Scope(const char* a_id) noexcept :
+				m_id(a_id),
+				m_start(t_count)
+			{
+			}
+
+			Scope::~Scope()
+			{
+				if (const auto n = t_count - m_start)
+				{
+					gLog.Warning("%s: %llu heap allocation(s)", m_id, n);
+				}
+			}
+		}
+	}
+}
+
+void* operator new(std::size_t a_size)
+{
+	SDS::Util::AllocCounter::Increment();
+
+	if (auto result = std::malloc(a_size ? a_size : 1))
+	{
+		return result;
+	}
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void* a_ptr) noexcept
+{
+	std::free(a_ptr);
+}
+
+void operator delete(void* a_ptr, std::size_t) noexcept
+{
+	std::free(a_ptr);
+}
+
+#endif
@@ -0,0 +1,31 @@
+#pragma once
+
+#ifdef _SDS_DEBUG
+
+namespace SDS
+{
+	namespace Util
+	{
+		namespace AllocCounter
+		{
+			// heap allocations made through operator new by this plugin on the calling thread
+			std::uint64_t Get() noexcept;
+
+			class Scope
+			{
+			public:
+				Scope(const char* a_id) noexcept;
+				~Scope();
+
+				Scope(const Scope&)            = delete;
+				Scope& operator=(const Scope&) = delete;
+
+			private:
+				const char*   m_id;
+				std::uint64_t m_start;
+			};
+		}
+	}
+}
+
+#endif
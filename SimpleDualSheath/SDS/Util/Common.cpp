@@ -2,6 +2,8 @@
 
 #include "Common.h"
 
+#include <skse64/GameCamera.h>
+
 namespace SDS
 {
 	namespace Util
@@ -62,6 +64,58 @@ namespace SDS
 				return armor->IsShield();
 			}
 
+			bool GetCameraPosition(NiPoint3& a_out)
+			{
+				const auto camera = PlayerCamera::GetSingleton();
+				if (!camera)
+				{
+					return false;
+				}
+
+				const auto node = camera->cameraNode;
+				if (!node)
+				{
+					return false;
+				}
+
+				a_out = node->m_worldTransform.pos;
+
+				return true;
+			}
+
+			TESForm* LookupFormSpec(const std::string& a_spec)
+			{
+				const auto pos = a_spec.rfind(':');
+				if (pos == std::string::npos)
+				{
+					return nullptr;
+				}
+
+				auto dh = DataHandler::GetSingleton();
+				if (!dh)
+				{
+					return nullptr;
+				}
+
+				const auto plugin = a_spec.substr(0, pos);
+
+				const auto modInfo = dh->LookupModByName(plugin.c_str());
+				if (!modInfo || !modInfo->IsActive())
+				{
+					return nullptr;
+				}
+
+				const auto lower = static_cast<std::uint32_t>(std::strtoul(a_spec.c_str() + pos + 1, nullptr, 16));
+
+				const auto index = modInfo->GetPartialIndex();
+
+				const auto formid = modInfo->IsLight() ?
+				                        (index << 12) | (lower & 0xFFF) :
+				                        (index << 24) | (lower & 0xFFFFFF);
+
+				return LookupFormByID(formid);
+			}
+
 		}
 	}
 }
\ No newline at end of file
@@ -9,6 +9,10 @@ namespace SDS
 			bool IsREFRValid(const TESObjectREFR* a_refr);
 			bool CanEquipEitherHand(const TESObjectWEAP* item);
 			bool IsShieldEquipped(const Actor* a_actor);
+			bool GetCameraPosition(NiPoint3& a_out);
+
+			// "Plugin.esp:0x800"
+			TESForm* LookupFormSpec(const std::string& a_spec);
 
 		}
 	}
@@ -15,6 +15,157 @@ namespace SDS
 				return a_root->GetObjectByName(a_name);
 			}
 
+			static bool FindNodePathImpl(
+				NiAVObject*          a_object,
+				const BSFixedString& a_name,
+				NodePath&            a_out,
+				bool&                a_truncated)
+			{
+				if (a_object->m_name == a_name)
+				{
+					return true;
+				}
+
+				auto node = a_object->AsNode();
+				if (!node)
+				{
+					return false;
+				}
+
+				if (a_out.depth >= MAX_PATH_DEPTH)
+				{
+					a_truncated = true;
+					return false;
+				}
+
+				for (std::uint16_t i = 0; i < node->m_children.freeidx(); i++)
+				{
+					if (const auto& e = node->m_children[i])
+					{
+						a_out.indices[a_out.depth++] = i;
+
+						if (FindNodePathImpl(e, a_name, a_out, a_truncated))
+						{
+							return true;
+						}
+
+						a_out.depth--;
+					}
+				}
+
+				return false;
+			}
+
+			PathSearchResult FindNodePath(
+				NiNode*              a_root,
+				const BSFixedString& a_name,
+				NodePath&            a_out)
+			{
+				a_out.depth = 0;
+
+				bool truncated = false;
+
+				if (!FindNodePathImpl(a_root, a_name, a_out, truncated))
+				{
+					return truncated ?
+					           PathSearchResult::kTruncated :
+					           PathSearchResult::kNotFound;
+				}
+
+				// same semantics as GetNodeByName, the match has to be a node
+				return ResolveNodePath(a_root, a_out, a_name) ?
+				           PathSearchResult::kFound :
+				           PathSearchResult::kNotFound;
+			}
+
+			NiNode* ResolveNodePath(
+				NiNode*              a_root,
+				const NodePath&      a_path,
+				const BSFixedString& a_name)
+			{
+				NiAVObject* current = a_root;
+
+				for (std::uint32_t i = 0; i < a_path.depth; i++)
+				{
+					auto node = current->AsNode();
+					if (!node)
+					{
+						return nullptr;
+					}
+
+					const auto index = a_path.indices[i];
+
+					if (index >= node->m_children.freeidx())
+					{
+						return nullptr;
+					}
+
+					current = node->m_children[index];
+					if (!current)
+					{
+						return nullptr;
+					}
+				}
+
+				return current->m_name == a_name ?
+				           current->AsNode() :
+				           nullptr;
+			}
+
+			static bool FindObjectsImpl(
+				NiAVObject*          a_object,
+				const BSFixedString& a_name1,
+				const BSFixedString& a_name2,
+				NiAVObject*&         a_out1,
+				NiAVObject*&         a_out2)
+			{
+				if (!a_out1 && a_object->m_name == a_name1)
+				{
+					a_out1 = a_object;
+				}
+				else if (!a_out2 && a_object->m_name == a_name2)
+				{
+					a_out2 = a_object;
+				}
+
+				if (a_out1 && a_out2)
+				{
+					return true;
+				}
+
+				auto node = a_object->AsNode();
+				if (!node)
+				{
+					return false;
+				}
+
+				for (std::uint16_t i = 0; i < node->m_children.freeidx(); i++)
+				{
+					if (const auto& e = node->m_children[i])
+					{
+						if (FindObjectsImpl(e, a_name1, a_name2, a_out1, a_out2))
+						{
+							return true;
+						}
+					}
+				}
+
+				return false;
+			}
+
+			void FindObjects(
+				NiAVObject*          a_root,
+				const BSFixedString& a_name1,
+				const BSFixedString& a_name2,
+				NiAVObject*&         a_out1,
+				NiAVObject*&         a_out2)
+			{
+				a_out1 = nullptr;
+				a_out2 = nullptr;
+
+				FindObjectsImpl(a_root, a_name1, a_name2, a_out1, a_out2);
+			}
+
 			void AttachToNode(
 				NiAVObject* a_object,
 				NiNode*     a_node)
@@ -25,6 +176,21 @@ namespace SDS
 				}
 			}
 
+			bool IsChildOf(
+				const NiAVObject* a_object,
+				const NiNode*     a_root) noexcept
+			{
+				for (auto parent = a_object->m_parent; parent; parent = parent->m_parent)
+				{
+					if (parent == a_root)
+					{
+						return true;
+					}
+				}
+
+				return false;
+			}
+
 		}
 	}
 }
\ No newline at end of file
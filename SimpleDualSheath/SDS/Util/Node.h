@@ -6,12 +6,50 @@ namespace SDS
 	{
 		namespace Node
 		{
+			inline static constexpr std::uint32_t MAX_PATH_DEPTH = 32;
+
+			struct NodePath
+			{
+				std::uint32_t depth{ 0 };
+				std::uint16_t indices[MAX_PATH_DEPTH];
+			};
+
 			NiAVObject* GetNiObject(NiNode* a_root, const BSFixedString& a_name);
 
+			enum class PathSearchResult : std::uint32_t
+			{
+				kFound,
+				kNotFound,
+				kTruncated  // hit MAX_PATH_DEPTH somewhere, can't say it isn't there
+			};
+
+			PathSearchResult FindNodePath(
+				NiNode*              a_root,
+				const BSFixedString& a_name,
+				NodePath&            a_out);
+
+			NiNode* ResolveNodePath(
+				NiNode*              a_root,
+				const NodePath&      a_path,
+				const BSFixedString& a_name);
+
+			// looks for two names in one pre-order traversal, first match for each wins (like GetNodeByName)
+			void FindObjects(
+				NiAVObject*          a_root,
+				const BSFixedString& a_name1,
+				const BSFixedString& a_name2,
+				NiAVObject*&         a_out1,
+				NiAVObject*&         a_out2);
+
 			void AttachToNode(
 				NiAVObject* a_object,
 				NiNode*     a_node);
 
+			// walks up the parents, false if the object was detached or its subtree was replaced
+			[[nodiscard]] bool IsChildOf(
+				const NiAVObject* a_object,
+				const NiNode*     a_root) noexcept;
+
 		}
 	}
 }
\ No newline at end of file
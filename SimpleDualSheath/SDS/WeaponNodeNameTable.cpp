@@ -0,0 +1,78 @@
+#include "pch.h"
+
+#include "WeaponNodeNameTable.h"
+
+namespace SDS
+{
+	BSFixedString WeaponNodeNameTable::MakeName(
+		const TESObjectWEAP* a_weapon)
+	{
+		char buf[1024];
+		a_weapon->GetNodeName(buf);
+
+		return buf;
+	}
+
+	void WeaponNodeNameTable::Populate()
+	{
+		m_data.clear();
+
+		auto dh = DataHandler::GetSingleton();
+		if (!dh)
+		{
+			return;
+		}
+
+		for (const auto& e : dh->weapons)
+		{
+			if (e)
+			{
+				m_data.try_emplace(e->formID, MakeName(e));
+			}
+		}
+
+		gLog.Debug(
+			"Weapon node names: %zu entries, ~%zu bytes",
+			m_data.size(),
+			GetMemoryUsage());
+	}
+
+	void WeaponNodeNameTable::ClearRuntime()
+	{
+		IScopedLock lock(m_lock);
+
+		m_runtime.clear();
+	}
+
+	const BSFixedString& WeaponNodeNameTable::Get(
+		const TESObjectWEAP* a_weapon)
+	{
+		auto it = m_data.find(a_weapon->formID);
+		if (it != m_data.end())
+		{
+			return it->second;
+		}
+
+		IScopedLock lock(m_lock);
+
+		auto& entry = m_runtime[a_weapon->formID];
+
+		// runtime form ids get reused
+		if (entry.form != a_weapon)
+		{
+			entry.form = a_weapon;
+			entry.name = MakeName(a_weapon);
+		}
+
+		return entry.name;
+	}
+
+	std::size_t WeaponNodeNameTable::GetMemoryUsage() const
+	{
+		// node: value + next/prev pointers, plus the bucket array
+		constexpr auto nodeSize = sizeof(decltype(m_data)::value_type) + sizeof(void*) * 2;
+
+		return m_data.size() * nodeSize +
+		       m_data.bucket_count() * sizeof(void*) * 2;
+	}
+}
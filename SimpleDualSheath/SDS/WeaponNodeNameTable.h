@@ -0,0 +1,37 @@
+#pragma once
+
+namespace SDS
+{
+	// interned TESObjectWEAP::GetNodeName results, so attaching/reparenting never touches the string pool
+	class WeaponNodeNameTable
+	{
+		struct RuntimeEntry
+		{
+			const TESObjectWEAP* form{ nullptr };
+			BSFixedString        name;
+		};
+
+	public:
+		WeaponNodeNameTable() = default;
+
+		WeaponNodeNameTable(const WeaponNodeNameTable&)            = delete;
+		WeaponNodeNameTable& operator=(const WeaponNodeNameTable&) = delete;
+
+		void Populate();
+		void ClearRuntime();
+
+		[[nodiscard]] const BSFixedString& Get(const TESObjectWEAP* a_weapon);
+
+		[[nodiscard]] std::size_t GetMemoryUsage() const;
+
+	private:
+		[[nodiscard]] static BSFixedString MakeName(const TESObjectWEAP* a_weapon);
+
+		// every weapon in the load order, not modified after Populate so lookups don't lock
+		std::unordered_map<Game::FormID, BSFixedString> m_data;
+
+		// forms created at runtime, filled on first use
+		mutable WCriticalSection                       m_lock;
+		std::unordered_map<Game::FormID, RuntimeEntry> m_runtime;
+	};
+}
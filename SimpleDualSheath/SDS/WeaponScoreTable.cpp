@@ -0,0 +1,102 @@
+#include "pch.h"
+
+#include "WeaponScoreTable.h"
+
+#include "Util/Common.h"
+
+namespace SDS
+{
+	using namespace Util::Common;
+
+	float WeaponScoreTable::GetEnchantmentMagnitude(
+		const TESObjectWEAP* a_weapon)
+	{
+		const auto enchantment = a_weapon->enchantment;
+		if (!enchantment)
+		{
+			return 0.0f;
+		}
+
+		float result = 0.0f;
+
+		for (auto& e : enchantment->effectItemList)
+		{
+			if (e)
+			{
+				result += e->magnitude;
+			}
+		}
+
+		return result;
+	}
+
+	float WeaponScoreTable::Compute(
+		const TESObjectWEAP* a_weapon) const
+	{
+		float result = m_weights.m_damage * static_cast<float>(a_weapon->attackDamage) +
+		               m_weights.m_speed * a_weapon->gameData.speed +
+		               m_weights.m_reach * a_weapon->gameData.reach;
+
+		if (m_weights.m_enchantment != 0.0f)
+		{
+			result += m_weights.m_enchantment * GetEnchantmentMagnitude(a_weapon);
+		}
+
+		return result;
+	}
+
+	void WeaponScoreTable::Populate(
+		const Config::EquipScoreWeights& a_weights)
+	{
+		m_weights = a_weights;
+		m_data.clear();
+
+		auto dh = DataHandler::GetSingleton();
+		if (!dh)
+		{
+			return;
+		}
+
+		for (const auto& e : dh->weapons)
+		{
+			if (e && CanEquipEitherHand(e))
+			{
+				m_data.try_emplace(e->formID, Compute(e));
+			}
+		}
+
+		gLog.Debug(
+			"Weapon scores: %zu entries, ~%zu bytes",
+			m_data.size(),
+			GetMemoryUsage());
+	}
+
+	float WeaponScoreTable::Get(
+		const TESObjectWEAP* a_weapon) const
+	{
+		auto it = m_data.find(a_weapon->formID);
+		if (it != m_data.end())
+		{
+			return it->second;
+		}
+
+		// created at runtime
+		return Compute(a_weapon);
+	}
+
+	float WeaponScoreTable::GetSkillTerm(
+		Actor*               a_actor,
+		const TESObjectWEAP* a_weapon) const
+	{
+		return m_weights.m_skill *
+		       a_actor->actorValueOwner.GetCurrent(a_weapon->gameData.skill);
+	}
+
+	std::size_t WeaponScoreTable::GetMemoryUsage() const
+	{
+		constexpr auto nodeSize = sizeof(decltype(m_data)::value_type) + sizeof(void*) * 2;
+
+		return m_data.size() * nodeSize +
+		       m_data.bucket_count() * sizeof(void*) * 2;
+	}
+}
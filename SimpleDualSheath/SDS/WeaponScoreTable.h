@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Config.h"
+
+namespace SDS
+{
+	// left-hand equip ranking, computed once on data load from the configured weights
+	class WeaponScoreTable
+	{
+	public:
+		WeaponScoreTable() = default;
+
+		WeaponScoreTable(const WeaponScoreTable&)            = delete;
+		WeaponScoreTable& operator=(const WeaponScoreTable&) = delete;
+
+		void Populate(const Config::EquipScoreWeights& a_weights);
+
+		[[nodiscard]] float Get(const TESObjectWEAP* a_weapon) const;
+
+		// actor dependent part, only applied to the best few candidates on evaluation
+		[[nodiscard]] float GetSkillTerm(Actor* a_actor, const TESObjectWEAP* a_weapon) const;
+
+		[[nodiscard]] inline constexpr bool HasSkillTerm() const noexcept
+		{
+			return m_weights.m_skill != 0.0f;
+		}
+
+		[[nodiscard]] std::size_t GetMemoryUsage() const;
+
+	private:
+		[[nodiscard]] float Compute(const TESObjectWEAP* a_weapon) const;
+		[[nodiscard]] static float GetEnchantmentMagnitude(const TESObjectWEAP* a_weapon);
+
+		Config::EquipScoreWeights m_weights;
+
+		// form dependent part of the score only, see GetSkillTerm
+		std::unordered_map<Game::FormID, float> m_data;
+	};
+}
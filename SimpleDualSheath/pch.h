@@ -23,9 +23,16 @@
 #include <skse64/NiNodes.h>
 #include <skse64/PluginAPI.h>
 
+#include <array>
+#include <chrono>
 #include <functional>
+#include <limits>
 #include <memory>
+#include <set>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "plugin.h"
 #include "skse.h"